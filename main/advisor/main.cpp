@@ -0,0 +1,68 @@
+#include <xparse/advisor.h>
+#include <xparse/loader.h>
+#include <xparse/log.h>
+
+#include <llvm/Support/CommandLine.h>
+
+static llvm::cl::OptionCategory s_category_option("XParse Advisor");
+
+static llvm::cl::list<std::string> s_inputs(
+    llvm::cl::Positional,
+    llvm::cl::desc("<metadata files>"),
+    llvm::cl::OneOrMore,
+    llvm::cl::cat(s_category_option));
+
+static llvm::cl::opt<bool> s_json(
+    "json",
+    llvm::cl::desc("Write the report as json instead of text."),
+    llvm::cl::init(false),
+    llvm::cl::cat(s_category_option));
+
+static void printAdvice(llvm::StringRef title, const std::vector<xparse::AdviceInfo>& advice, llvm::StringRef target_prefix)
+{
+    llvm::outs() << title << " (" << advice.size() << "):\n";
+    for (const auto& info : advice) {
+        llvm::outs() << "    " << info.full_name;
+        if (!info.target.empty()) {
+            llvm::outs() << " " << target_prefix << " " << info.target;
+        }
+        if (info.virtual_methods > 0) {
+            llvm::outs() << " [" << info.virtual_methods << " virtual methods]";
+        }
+        llvm::outs() << "\n        " << info.file << "\n";
+    }
+    llvm::outs() << "\n";
+}
+
+int main(int argc, char** argv)
+{
+    llvm::cl::HideUnrelatedOptions(s_category_option);
+    llvm::cl::ParseCommandLineOptions(argc, argv,
+        "Report virtual methods with a single implementation, classes that could be marked final "
+        "and interfaces with a single concrete subclass in xparse metadata.\n");
+
+    xparse::DevirtAdvisor advisor;
+    for (const auto& input : s_inputs) {
+        auto metadata = xparse::loadProjectMetaInfo(input);
+        if (!metadata) {
+            XPARSE_LOG_ERROR("{0}", llvm::toString(metadata.takeError()));
+            return -1;
+        }
+        advisor.add(std::move(*metadata));
+    }
+
+    auto report = advisor.analyze();
+
+    if (s_json) {
+        llvm::json::OStream json_outs { llvm::outs(), 2 };
+        xparse::Serializer::serialize(json_outs, report);
+        llvm::outs() << "\n";
+    } else {
+        printAdvice("virtual methods with a single implementation", report.single_implementation_methods, "implemented by");
+        printAdvice("classes that could be marked final", report.final_candidates, "");
+        printAdvice("interfaces with a single concrete subclass", report.single_subclass_interfaces, "implemented by");
+    }
+    llvm::outs().flush();
+
+    return 0;
+}
@@ -0,0 +1,5 @@
+target("advisor")
+    set_basename("xparse-advisor")
+    set_kind("binary")
+    add_deps("xparse-base")
+    add_files("**.cpp")
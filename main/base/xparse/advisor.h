@@ -0,0 +1,248 @@
+/**
+ * *****************************************************************************
+ * @file        advisor.h
+ * @brief       Find devirtualization and `final` opportunities in the project class hierarchy.
+ * @author      hsz (hszsoftware@qq.com)
+ * @date        2026-10-19
+ * @copyright   hszsoft
+ * *****************************************************************************
+ */
+
+#ifndef __XPARSE_ADVISOR_H__
+#define __XPARSE_ADVISOR_H__
+
+#include "meta.h"
+
+#include <algorithm>
+#include <deque>
+#include <tuple>
+#include <unordered_set>
+
+namespace xparse {
+
+/**
+ * @brief       A method or record that the compiler could devirtualize if it knew the hierarchy is closed.
+ * @note        `target` is the only implementation of a method or the only concrete subclass of an interface.
+ */
+struct AdviceInfo {
+    std::string id;
+    std::string full_name;
+    std::string file;
+    std::string target;
+    size_t virtual_methods = 0;
+};
+
+XPARSE_SERIALIZE_OBJECT(AdviceInfo)
+{
+    XPARSE_SERIALIZE_ATTR(id);
+    XPARSE_SERIALIZE_ATTR(full_name);
+    XPARSE_SERIALIZE_ATTR(file);
+    XPARSE_SERIALIZE_ATTR(target);
+    XPARSE_SERIALIZE_ATTR(virtual_methods);
+}
+
+struct AdviceReportInfo {
+    std::vector<AdviceInfo> single_implementation_methods;
+    std::vector<AdviceInfo> final_candidates;
+    std::vector<AdviceInfo> single_subclass_interfaces;
+};
+
+XPARSE_SERIALIZE_OBJECT(AdviceReportInfo)
+{
+    XPARSE_SERIALIZE_ATTR(single_implementation_methods);
+    XPARSE_SERIALIZE_ATTR(final_candidates);
+    XPARSE_SERIALIZE_ATTR(single_subclass_interfaces);
+}
+
+inline bool isEmpty(const AdviceReportInfo& report)
+{
+    return report.single_implementation_methods.empty() && report.final_candidates.empty() && report.single_subclass_interfaces.empty();
+}
+
+/**
+ * @brief       Builds the class hierarchy of one or more metadata files and reports what could be devirtualized.
+ * @note        Only reflected records are known, so the advice holds for the analyzed metadata only. A class
+ *              derived outside of it, e.g. by a plugin, invalidates advice about its bases.
+ */
+class DevirtAdvisor {
+public:
+    /**
+     * @brief       Add the metadata of a project, records with the same id are merged.
+     */
+    void add(ProjectMetaInfo metadata);
+
+    AdviceReportInfo analyze() const;
+
+private:
+    struct RecordNode {
+        const RecordMetaInfo* info = nullptr;
+        std::string file;
+        std::vector<std::string> derived;
+    };
+
+    struct MethodNode {
+        const MethodMetaInfo* info = nullptr;
+        std::string record_id;
+        std::vector<std::string> overriders;
+    };
+
+    void collectDerived(const std::string& id, std::unordered_set<std::string>& derived) const;
+
+    static size_t countVirtualMethods(const RecordMetaInfo& info);
+    static void sortAdvice(std::vector<AdviceInfo>& advice);
+
+    std::deque<ProjectMetaInfo>                 m_metadata;
+    std::unordered_map<std::string, RecordNode> m_records;
+    std::unordered_map<std::string, MethodNode> m_methods;
+};
+
+inline void DevirtAdvisor::add(ProjectMetaInfo metadata)
+{
+    // deque keeps elements in place, so the nodes can point into the metadata.
+    const auto& project_metadata = m_metadata.emplace_back(std::move(metadata));
+
+    for (const auto& [filename, file_metadata] : project_metadata) {
+        for (const auto& record : file_metadata.records) {
+            if (record.id.empty() || m_records.count(record.id) > 0) {
+                continue;
+            }
+            m_records[record.id] = RecordNode { &record, filename, {} };
+            for (const auto& method : record.methods) {
+                if (!method.id.empty()) {
+                    m_methods[method.id] = MethodNode { &method, record.id, {} };
+                }
+            }
+        }
+    }
+
+    // edges are rebuilt since a later file can contain the bases of an earlier one.
+    for (auto& [id, node] : m_records) {
+        node.derived.clear();
+    }
+    for (auto& [id, node] : m_methods) {
+        node.overriders.clear();
+    }
+    for (const auto& [id, node] : m_records) {
+        for (const auto& base_ref : node.info->base_refs) {
+            auto iter = m_records.find(base_ref);
+            if (iter != m_records.end()) {
+                iter->second.derived.push_back(id);
+            }
+        }
+    }
+    for (const auto& [id, node] : m_methods) {
+        for (const auto& overridden : node.info->overrides) {
+            auto iter = m_methods.find(overridden);
+            if (iter != m_methods.end()) {
+                iter->second.overriders.push_back(id);
+            }
+        }
+    }
+}
+
+inline AdviceReportInfo DevirtAdvisor::analyze() const
+{
+    AdviceReportInfo report;
+
+    for (const auto& [id, node] : m_methods) {
+        const auto& method = *node.info;
+        // start from the method that introduces the virtual function and walk all overriders.
+        if (!method.is_virtual || !method.overrides.empty()) {
+            continue;
+        }
+
+        size_t implementations = 0;
+        const MethodNode* implementation = nullptr;
+        // with virtual inheritance a method is reached once through every base it overrides.
+        std::unordered_set<std::string> visited { id };
+        std::vector<const MethodNode*> pending { &node };
+        while (!pending.empty()) {
+            const auto* current = pending.back();
+            pending.pop_back();
+            if (!current->info->is_pure_virtual) {
+                ++implementations;
+                implementation = current;
+            }
+            for (const auto& overrider : current->overriders) {
+                if (visited.insert(overrider).second) {
+                    pending.push_back(&m_methods.at(overrider));
+                }
+            }
+        }
+
+        if (implementations == 1) {
+            const auto& record = m_records.at(node.record_id);
+            report.single_implementation_methods.push_back(AdviceInfo {
+                id,
+                record.info->full_name + "::" + method.name,
+                record.file,
+                m_records.at(implementation->record_id).info->full_name });
+        }
+    }
+
+    for (const auto& [id, node] : m_records) {
+        const auto& record = *node.info;
+        auto virtual_methods = countVirtualMethods(record);
+        if (!(record.is_polymorphic || virtual_methods > 0)) {
+            continue;
+        }
+
+        if (node.derived.empty() && !record.is_final && !record.is_abstract) {
+            report.final_candidates.push_back(AdviceInfo { id, record.full_name, node.file, "", virtual_methods });
+        }
+
+        if (record.is_abstract) {
+            std::unordered_set<std::string> derived;
+            this->collectDerived(id, derived);
+
+            const RecordNode* concrete = nullptr;
+            size_t concrete_count = 0;
+            for (const auto& derived_id : derived) {
+                const auto& derived_node = m_records.at(derived_id);
+                if (!derived_node.info->is_abstract) {
+                    concrete = &derived_node;
+                    ++concrete_count;
+                }
+            }
+            if (concrete_count == 1) {
+                report.single_subclass_interfaces.push_back(
+                    AdviceInfo { id, record.full_name, node.file, concrete->info->full_name, virtual_methods });
+            }
+        }
+    }
+
+    sortAdvice(report.single_implementation_methods);
+    sortAdvice(report.final_candidates);
+    sortAdvice(report.single_subclass_interfaces);
+    // interfaces with the most virtual methods gain the most from being replaced by their only subclass.
+    std::stable_sort(report.single_subclass_interfaces.begin(), report.single_subclass_interfaces.end(),
+        [](const AdviceInfo& lhs, const AdviceInfo& rhs) { return lhs.virtual_methods > rhs.virtual_methods; });
+    return report;
+}
+
+inline void DevirtAdvisor::collectDerived(const std::string& id, std::unordered_set<std::string>& derived) const
+{
+    for (const auto& derived_id : m_records.at(id).derived) {
+        if (derived.insert(derived_id).second) {
+            this->collectDerived(derived_id, derived);
+        }
+    }
+}
+
+inline size_t DevirtAdvisor::countVirtualMethods(const RecordMetaInfo& info)
+{
+    return std::count_if(info.methods.begin(), info.methods.end(), [](const MethodMetaInfo& method) {
+        return method.is_virtual;
+    });
+}
+
+inline void DevirtAdvisor::sortAdvice(std::vector<AdviceInfo>& advice)
+{
+    std::sort(advice.begin(), advice.end(), [](const AdviceInfo& lhs, const AdviceInfo& rhs) {
+        return std::tie(lhs.file, lhs.full_name, lhs.id) < std::tie(rhs.file, rhs.full_name, rhs.id);
+    });
+}
+
+} // namespace xparse
+
+#endif // __XPARSE_ADVISOR_H__
@@ -0,0 +1,205 @@
+/**
+ * *****************************************************************************
+ * @file        compression.h
+ * @brief       Framed zlib/zstd compression of metadata, readable as a stream.
+ * @author      hsz (hszsoftware@qq.com)
+ * @date        2026-10-19
+ * @copyright   hszsoft
+ * *****************************************************************************
+ */
+
+#ifndef __XPARSE_COMPRESSION_H__
+#define __XPARSE_COMPRESSION_H__
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/Compression.h>
+#include <llvm/Support/Endian.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <string>
+
+namespace xparse {
+
+enum class CompressionKind : std::uint8_t {
+    kNone = 0,
+    kZlib = 1,
+    kZstd = 2
+};
+
+/**
+ * Layout of compressed metadata, all integers are little endian:
+ *
+ *     "XPMZ" | version: u8 | kind: u8 | frame... | end frame
+ *     frame:     raw size: u32 | compressed size: u32 | compressed data
+ *     end frame: raw size 0 and compressed size 0
+ *
+ * Frames are compressed independently, so a reader only needs one frame in memory.
+ */
+namespace detail {
+
+    constexpr llvm::StringLiteral kCompressionMagic = "XPMZ";
+    constexpr std::uint8_t kCompressionVersion = 1;
+    constexpr size_t kCompressionHeaderSize = 6;
+    constexpr size_t kFrameHeaderSize = 8;
+
+    inline llvm::compression::Format getCompressionFormat(CompressionKind kind)
+    {
+        return kind == CompressionKind::kZstd ? llvm::compression::Format::Zstd : llvm::compression::Format::Zlib;
+    }
+
+    inline llvm::ArrayRef<std::uint8_t> toBytes(llvm::StringRef content)
+    {
+        return { reinterpret_cast<const std::uint8_t*>(content.data()), content.size() };
+    }
+
+} // namespace detail
+
+/**
+ * @return      nullptr if the compression kind can be used, the reason otherwise.
+ */
+inline const char* getUnsupportedReason(CompressionKind kind)
+{
+    if (kind == CompressionKind::kNone) {
+        return nullptr;
+    }
+    return llvm::compression::getReasonIfUnsupported(detail::getCompressionFormat(kind));
+}
+
+inline bool isCompressed(llvm::StringRef content)
+{
+    return content.starts_with(detail::kCompressionMagic);
+}
+
+/**
+ * @brief       Compresses everything written to it in frames of a fixed raw size and forwards them to another stream.
+ * @note        The end frame is written by finish() or on destruction, the kind must be supported.
+ */
+class CompressedOStream : public llvm::raw_ostream {
+public:
+    static constexpr size_t kDefaultFrameSize = 1024 * 1024;
+
+    CompressedOStream(llvm::raw_ostream& outs, CompressionKind kind, size_t frame_size = kDefaultFrameSize)
+        : m_outs(outs)
+        , m_kind(kind)
+        , m_frame_size(frame_size)
+    {
+        m_outs << detail::kCompressionMagic;
+        m_outs << static_cast<char>(detail::kCompressionVersion) << static_cast<char>(m_kind);
+    }
+
+    ~CompressedOStream() override { this->finish(); }
+
+    void finish()
+    {
+        if (m_finished) {
+            return;
+        }
+        this->flush();
+        this->writeFrame(m_pending);
+        m_pending.clear();
+        this->writeFrameHeader(0, 0);
+        m_finished = true;
+    }
+
+private:
+    void write_impl(const char* ptr, size_t size) override
+    {
+        m_position += size;
+        llvm::StringRef content(ptr, size);
+        while (!content.empty()) {
+            auto count = std::min(content.size(), m_frame_size - m_pending.size());
+            m_pending.append(content.data(), count);
+            content = content.drop_front(count);
+            if (m_pending.size() == m_frame_size) {
+                this->writeFrame(m_pending);
+                m_pending.clear();
+            }
+        }
+    }
+
+    std::uint64_t current_pos() const override { return m_position; }
+
+    void writeFrame(llvm::StringRef content)
+    {
+        if (content.empty()) {
+            return;
+        }
+        m_compressed.clear();
+        llvm::compression::compress(detail::getCompressionFormat(m_kind), detail::toBytes(content), m_compressed);
+        this->writeFrameHeader(static_cast<std::uint32_t>(content.size()), static_cast<std::uint32_t>(m_compressed.size()));
+        m_outs.write(reinterpret_cast<const char*>(m_compressed.data()), m_compressed.size());
+    }
+
+    void writeFrameHeader(std::uint32_t raw_size, std::uint32_t compressed_size)
+    {
+        char header[detail::kFrameHeaderSize];
+        llvm::support::endian::write32le(header, raw_size);
+        llvm::support::endian::write32le(header + 4, compressed_size);
+        m_outs.write(header, sizeof(header));
+    }
+
+    llvm::raw_ostream&                  m_outs;
+    CompressionKind                     m_kind;
+    size_t                              m_frame_size;
+    std::string                         m_pending;
+    llvm::SmallVector<std::uint8_t, 0>  m_compressed;
+    std::uint64_t                       m_position = 0;
+    bool                                m_finished = false;
+};
+
+/**
+ * @brief       Decompress content written by CompressedOStream.
+ */
+inline llvm::Expected<std::string> decompress(llvm::StringRef content)
+{
+    auto error = [](const char* message) {
+        return llvm::createStringError(llvm::inconvertibleErrorCode(), "malformed compressed metadata: %s", message);
+    };
+
+    if (!isCompressed(content) || content.size() < detail::kCompressionHeaderSize) {
+        return error("missing header");
+    }
+    if (static_cast<std::uint8_t>(content[4]) != detail::kCompressionVersion) {
+        return error("unknown version");
+    }
+    auto kind = static_cast<CompressionKind>(content[5]);
+    if (kind != CompressionKind::kZlib && kind != CompressionKind::kZstd) {
+        return error("unknown compression kind");
+    }
+    if (const auto* reason = getUnsupportedReason(kind)) {
+        return llvm::createStringError(llvm::inconvertibleErrorCode(), "%s", reason);
+    }
+
+    std::string result;
+    llvm::SmallVector<std::uint8_t, 0> frame;
+    content = content.drop_front(detail::kCompressionHeaderSize);
+    while (true) {
+        if (content.size() < detail::kFrameHeaderSize) {
+            return error("truncated frame header");
+        }
+        auto raw_size = llvm::support::endian::read32le(content.data());
+        auto compressed_size = llvm::support::endian::read32le(content.data() + 4);
+        content = content.drop_front(detail::kFrameHeaderSize);
+        if (raw_size == 0 && compressed_size == 0) {
+            break;
+        }
+        if (content.size() < compressed_size) {
+            return error("truncated frame");
+        }
+
+        frame.clear();
+        if (auto decompress_error = llvm::compression::decompress(detail::getCompressionFormat(kind),
+                detail::toBytes(content.take_front(compressed_size)), frame, raw_size)) {
+            return std::move(decompress_error);
+        }
+        result.append(reinterpret_cast<const char*>(frame.data()), frame.size());
+        content = content.drop_front(compressed_size);
+    }
+    return result;
+}
+
+} // namespace xparse
+
+#endif // __XPARSE_COMPRESSION_H__
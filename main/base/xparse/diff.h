@@ -0,0 +1,127 @@
+/**
+ * *****************************************************************************
+ * @file        diff.h
+ * @brief       Compare two versions of project metadata by entity hash.
+ * @author      hsz (hszsoftware@qq.com)
+ * @date        2026-10-19
+ * @copyright   hszsoft
+ * *****************************************************************************
+ */
+
+#ifndef __XPARSE_DIFF_H__
+#define __XPARSE_DIFF_H__
+
+#include "meta.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace xparse {
+
+/**
+ * @brief       A record, function or enum that differs between two runs.
+ *
+ */
+struct ChangeInfo {
+    std::string kind;
+    std::string id;
+    std::string full_name;
+    std::string file;
+};
+
+XPARSE_SERIALIZE_OBJECT(ChangeInfo)
+{
+    XPARSE_SERIALIZE_ATTR(kind);
+    XPARSE_SERIALIZE_ATTR(id);
+    XPARSE_SERIALIZE_ATTR(full_name);
+    XPARSE_SERIALIZE_ATTR(file);
+}
+
+struct DiffInfo {
+    std::vector<ChangeInfo> added;
+    std::vector<ChangeInfo> removed;
+    std::vector<ChangeInfo> changed;
+};
+
+XPARSE_SERIALIZE_OBJECT(DiffInfo)
+{
+    XPARSE_SERIALIZE_ATTR(added);
+    XPARSE_SERIALIZE_ATTR(removed);
+    XPARSE_SERIALIZE_ATTR(changed);
+}
+
+inline bool isEmpty(const DiffInfo& diff)
+{
+    return diff.added.empty() && diff.removed.empty() && diff.changed.empty();
+}
+
+namespace detail {
+
+    struct HashedEntity {
+        ChangeInfo info;
+        std::string hash;
+    };
+
+    /**
+     * @brief       Index entities by id, falling back to kind and full name for metadata without ids.
+     */
+    inline std::unordered_map<std::string, HashedEntity> indexEntities(const ProjectMetaInfo& metadata)
+    {
+        std::unordered_map<std::string, HashedEntity> entities;
+        auto add = [&](const char* kind, const auto& info, const std::string& file) {
+            auto key = info.id.empty() ? std::string(kind) + ":" + info.full_name : info.id;
+            entities[key] = HashedEntity { ChangeInfo { kind, info.id, info.full_name, file }, info.hash };
+        };
+
+        for (const auto& [filename, file_metadata] : metadata) {
+            for (const auto& record : file_metadata.records) {
+                add("record", record, filename);
+            }
+            for (const auto& function : file_metadata.functions) {
+                add("function", function, filename);
+            }
+            for (const auto& enum_info : file_metadata.enums) {
+                add("enum", enum_info, filename);
+            }
+        }
+        return entities;
+    }
+
+    inline void sortChanges(std::vector<ChangeInfo>& changes)
+    {
+        std::sort(changes.begin(), changes.end(), [](const ChangeInfo& lhs, const ChangeInfo& rhs) {
+            return std::tie(lhs.file, lhs.full_name, lhs.id) < std::tie(rhs.file, rhs.full_name, rhs.id);
+        });
+    }
+
+} // namespace detail
+
+inline DiffInfo diffMetadata(const ProjectMetaInfo& previous, const ProjectMetaInfo& current)
+{
+    auto previous_entities = detail::indexEntities(previous);
+    auto current_entities = detail::indexEntities(current);
+
+    DiffInfo diff;
+    for (const auto& [key, entity] : current_entities) {
+        auto iter = previous_entities.find(key);
+        if (iter == previous_entities.end()) {
+            diff.added.push_back(entity.info);
+        } else if (iter->second.hash != entity.hash || iter->second.info.file != entity.info.file) {
+            diff.changed.push_back(entity.info);
+        }
+    }
+    for (const auto& [key, entity] : previous_entities) {
+        if (current_entities.count(key) == 0) {
+            diff.removed.push_back(entity.info);
+        }
+    }
+
+    detail::sortChanges(diff.added);
+    detail::sortChanges(diff.removed);
+    detail::sortChanges(diff.changed);
+    return diff;
+}
+
+} // namespace xparse
+
+#endif // __XPARSE_DIFF_H__
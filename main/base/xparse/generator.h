@@ -0,0 +1,837 @@
+/**
+ * *****************************************************************************
+ * @file        generator.h
+ * @brief       Generate C++ code from the extracted metadata.
+ * @author      hsz (hszsoftware@qq.com)
+ * @date        2026-10-19
+ * @copyright   hszsoft
+ * *****************************************************************************
+ */
+
+#ifndef __XPARSE_GENERATOR_H__
+#define __XPARSE_GENERATOR_H__
+
+#include "log.h"
+#include "meta.h"
+
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/xxhash.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace xparse {
+
+namespace detail {
+
+    inline std::string escapeString(llvm::StringRef input)
+    {
+        std::string output;
+        for (char c : input) {
+            if (c == '"' || c == '\\') {
+                output += '\\';
+            }
+            output += c;
+        }
+        return output;
+    }
+
+    /**
+     * @brief       Records in anonymous namespaces, local classes and non-public
+     *              nested classes cannot be named from the generated header.
+     */
+    inline bool isNameable(const RecordMetaInfo& info)
+    {
+        return info.full_name.find('(') == std::string::npos && (info.access == "public" || info.access == "none");
+    }
+
+    inline bool isAccessible(const FieldMetaInfo& info)
+    {
+        bool is_reference = !info.raw_type.empty() && info.raw_type.back() == '&';
+        return info.access == "public" && !info.is_bitfield && !is_reference;
+    }
+
+    inline bool isAccessible(const MethodMetaInfo& info)
+    {
+        return info.access == "public" && !info.is_deleted;
+    }
+
+    /**
+     * @brief       Fields of a record that gets a SoA container, or empty if any of them cannot be stored in a column.
+     */
+    inline std::vector<const FieldMetaInfo*> getColumnFields(const RecordMetaInfo& info)
+    {
+        // a row is converted back by assigning every column to a default constructed record, inherited members would be lost.
+        if (!info.bases.empty()) {
+            XPARSE_LOG_WARN("record {0} has base classes, no SoA container is generated.", info.full_name);
+            return {};
+        }
+        if (!info.is_default_constructible) {
+            XPARSE_LOG_WARN("record {0} is not default constructible, no SoA container is generated.", info.full_name);
+            return {};
+        }
+
+        std::vector<const FieldMetaInfo*> fields;
+        for (const auto& field : info.fields) {
+            if (field.is_static) {
+                continue;
+            }
+
+            // columns are assigned element-wise, which rules out const and array members.
+            bool is_const = field.raw_type.rfind("const ", 0) == 0;
+            bool is_array = field.raw_type.find('[') != std::string::npos;
+            if (!isAccessible(field) || is_const || is_array) {
+                XPARSE_LOG_WARN("field {0}::{1} cannot be stored in a column, no SoA container is generated.", info.full_name, field.name);
+                return {};
+            }
+            fields.push_back(&field);
+        }
+        return fields;
+    }
+
+    /**
+     * @brief       Name of the column accessor, suffixed if the field name is taken by the container itself.
+     */
+    inline std::string getColumnName(const std::string& field_name)
+    {
+        static const char* const kReservedNames[] = {
+            "Type", "Storage", "Ref", "ConstRef", "ColumnType", "kColumnAlignment",
+            "size", "capacity", "empty", "reserve", "clear", "emplace", "pop", "erase", "swapErase",
+            "column", "push", "get", "set", "fromAoS", "toAoS"
+        };
+        for (const auto* reserved_name : kReservedNames) {
+            if (field_name == reserved_name) {
+                return field_name + "_";
+            }
+        }
+        return field_name;
+    }
+
+    inline bool hasFlag(const AttrMetaInfo& annotation, llvm::StringRef flag)
+    {
+        return std::any_of(annotation.values.begin(), annotation.values.end(), [&](const AttrValueMetaInfo& value) {
+            return value.kind == "string" && value.string_value == flag;
+        });
+    }
+
+    /**
+     * @brief       Fields annotated with `hash=false` take part in neither hashing nor equality.
+     */
+    inline bool isHashed(const FieldMetaInfo& info)
+    {
+        const auto* annotation = findAnnotation(info, "hash");
+        return !info.is_static
+            && !(annotation && !annotation->values.empty() && annotation->values[0].kind == "bool" && !annotation->values[0].bool_value);
+    }
+
+    /**
+     * @brief       Consecutive fields that are compared and hashed together, as bytes if `is_bitwise`.
+     */
+    struct HashGroup {
+        std::vector<const FieldMetaInfo*> fields;
+        bool is_bitwise = false;
+    };
+
+    /**
+     * @brief       Group the hashed fields of a record, or empty if any of them cannot be accessed.
+     * @note        Bitwise comparable fields without padding between them form one group, which is
+     *              compared with a single memcmp. Groups compared as bytes come first, since they are the cheapest.
+     */
+    inline std::vector<HashGroup> getHashGroups(const RecordMetaInfo& info)
+    {
+        std::vector<HashGroup> bitwise_groups;
+        std::vector<HashGroup> groups;
+        const FieldMetaInfo* previous = nullptr;
+        for (const auto& field : info.fields) {
+            if (!isHashed(field)) {
+                continue;
+            }
+
+            bool is_reference = !field.raw_type.empty() && field.raw_type.back() == '&';
+            if (field.access != "public" || is_reference) {
+                XPARSE_LOG_WARN("field {0}::{1} cannot be hashed, annotate it with hash=false to exclude it.", info.full_name, field.name);
+                return {};
+            }
+
+            if (!field.is_bitwise_comparable) {
+                groups.push_back(HashGroup { { &field }, false });
+                previous = nullptr;
+                continue;
+            }
+
+            bool is_adjacent = previous != nullptr && previous->offset + previous->size == field.offset;
+            if (is_adjacent) {
+                bitwise_groups.back().fields.push_back(&field);
+            } else {
+                bitwise_groups.push_back(HashGroup { { &field }, true });
+            }
+            previous = &field;
+        }
+
+        // a single scalar is cheaper to compare by value than through memcmp.
+        for (auto& group : bitwise_groups) {
+            bool is_array = group.fields[0]->raw_type.find('[') != std::string::npos;
+            group.is_bitwise = group.fields.size() > 1 || is_array;
+        }
+        bitwise_groups.insert(bitwise_groups.end(), groups.begin(), groups.end());
+        return bitwise_groups;
+    }
+
+    /**
+     * @brief       Byte size of a group compared as bytes, as an expression of the generated code.
+     */
+    inline std::string getHashGroupSize(const HashGroup& group)
+    {
+        const auto& first = group.fields.front()->name;
+        const auto& last = group.fields.back()->name;
+        if (group.fields.size() == 1) {
+            return "sizeof(Type::" + first + ")";
+        }
+        return "offsetof(Type, " + last + ") + sizeof(Type::" + last + ") - offsetof(Type, " + first + ")";
+    }
+
+} // namespace detail
+
+/**
+ * @brief       Writes one header with generated code per source header, and an umbrella header including all of them.
+ * @note        Each generated header starts with a stamp derived from the hashes of the entities it is generated
+ *              from, so an up to date header is neither regenerated nor rewritten. Sources including only the
+ *              generated headers they use are not rebuilt when an unrelated source header changes.
+ */
+class Generator {
+public:
+    Generator(const ProjectMetaInfo& metadata);
+
+    /**
+     * @brief       Source headers containing generated records, sorted.
+     */
+    const std::vector<std::string>& getSourceFiles() const { return m_filenames; }
+
+    /**
+     * @brief       Name of the header generated for a source header, unique within the project.
+     */
+    const std::string& getOutputName(const std::string& filename) const { return m_output_names.at(filename); }
+
+    /**
+     * @brief       First line of the header generated for a source header, changes whenever its content would.
+     */
+    std::string getStamp(const std::string& filename) const;
+
+    /**
+     * @brief       Generate the header of a single source header.
+     */
+    void generateFile(const std::string& filename, llvm::raw_ostream& outs);
+
+    /**
+     * @brief       Generate the umbrella header, including every generated header from `directory`.
+     */
+    void generate(llvm::raw_ostream& outs, llvm::StringRef directory);
+
+protected:
+    void generateRegistry(const RecordMetaInfo& info, llvm::raw_ostream& outs);
+    void generateSoA(const RecordMetaInfo& info, llvm::raw_ostream& outs);
+    void generateHash(const RecordMetaInfo& info, llvm::raw_ostream& outs);
+    void generateHashOperators(const RecordMetaInfo& info, llvm::raw_ostream& outs);
+
+private:
+    struct RecordEntry {
+        const RecordMetaInfo* info = nullptr;
+        std::string filename;
+        bool is_hashed = false;
+    };
+
+    /**
+     * @brief       Record stored by value in a field, or nullptr if it is not a generated record.
+     */
+    const RecordEntry* findFieldRecord(const FieldMetaInfo& info) const;
+
+    /**
+     * @brief       Record of the base at `index`, or nullptr if it is not a generated record.
+     */
+    const RecordEntry* findBaseRecord(const RecordMetaInfo& info, size_t index) const;
+
+    /**
+     * @brief       Scalars, strings and hashed records have a Hash, anything else would not compile.
+     */
+    bool isHashable(const FieldMetaInfo& info) const;
+
+    /**
+     * @brief       Hashed records of other source headers whose Hash a record of `filename` uses.
+     */
+    std::vector<const RecordEntry*> getHashDependencies(const std::string& filename) const;
+
+    std::vector<std::string>                                             m_filenames;
+    std::unordered_map<std::string, std::vector<const RecordMetaInfo*>>  m_records;
+    std::unordered_map<std::string, RecordEntry>                         m_record_entries;
+    std::unordered_map<std::string, std::string>                         m_output_names;
+};
+
+namespace detail {
+
+    inline std::string getRecordKey(const RecordMetaInfo& info)
+    {
+        return info.id.empty() ? info.full_name : info.id;
+    }
+
+    /**
+     * @brief       Type of a field without qualifiers, tag keywords, leading `::` and array extents.
+     */
+    inline llvm::StringRef getElementType(llvm::StringRef type)
+    {
+        type = type.take_until([](char c) { return c == '['; }).trim();
+        for (llvm::StringRef prefix : { "const ", "volatile ", "struct ", "class ", "union ", "::" }) {
+            type.consume_front(prefix);
+        }
+        return type;
+    }
+
+} // namespace detail
+
+inline Generator::Generator(const ProjectMetaInfo& metadata)
+{
+    // keep the output stable between runs, the metadata is keyed by an unordered map.
+    std::vector<std::string> filenames;
+    for (const auto& [filename, file_metadata] : metadata) {
+        if (!file_metadata.records.empty()) {
+            filenames.push_back(filename);
+        }
+    }
+    std::sort(filenames.begin(), filenames.end());
+
+    // a record is generated once even if merged metadata lists it more than once, a second definition would not compile.
+    for (const auto& filename : filenames) {
+        for (const auto& record : metadata.at(filename).records) {
+            if (!detail::isNameable(record)) {
+                continue;
+            }
+            auto [iter, inserted] = m_record_entries.try_emplace(detail::getRecordKey(record), RecordEntry { &record, filename });
+            if (!inserted) {
+                continue;
+            }
+            // a derived record may have no hashed fields of its own, its bases are hashed first.
+            bool has_hashed_fields = std::any_of(record.fields.begin(), record.fields.end(), detail::isHashed);
+            iter->second.is_hashed = findAnnotation(record, "hash")
+                && (!detail::getHashGroups(record).empty() || (!has_hashed_fields && !record.bases.empty()));
+            auto& records = m_records[filename];
+            if (records.empty()) {
+                m_filenames.push_back(filename);
+            }
+            records.push_back(&record);
+        }
+    }
+
+    // a record is hashed only if all its bases and hashed fields are, which may in turn be hashed records.
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (const auto& filename : m_filenames) {
+            for (const auto* record : m_records[filename]) {
+                auto& entry = m_record_entries.at(detail::getRecordKey(*record));
+                if (!entry.is_hashed) {
+                    continue;
+                }
+                for (size_t i = 0; i < record->bases.size(); ++i) {
+                    const auto* base = this->findBaseRecord(*record, i);
+                    if (base == nullptr || !base->is_hashed) {
+                        XPARSE_LOG_WARN("base {0} of {1} has no hash, annotate it with hash to include it.", record->bases[i], record->full_name);
+                        entry.is_hashed = false;
+                        changed = true;
+                        break;
+                    }
+                }
+                if (!entry.is_hashed) {
+                    continue;
+                }
+                auto iter = std::find_if(record->fields.begin(), record->fields.end(), [&](const FieldMetaInfo& field) {
+                    return detail::isHashed(field) && !this->isHashable(field);
+                });
+                if (iter != record->fields.end()) {
+                    XPARSE_LOG_WARN("field {0}::{1} of type \"{2}\" has no hash, annotate it with hash=false to exclude it.",
+                        record->full_name, iter->name, iter->type);
+                    entry.is_hashed = false;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // source headers in different directories may share a name.
+    std::unordered_map<std::string, size_t> stem_counts;
+    for (const auto& filename : m_filenames) {
+        ++stem_counts[llvm::sys::path::stem(filename).str()];
+    }
+    for (const auto& filename : m_filenames) {
+        auto stem = llvm::sys::path::stem(filename).str();
+        if (stem_counts[stem] > 1) {
+            stem += "_" + llvm::utohexstr(llvm::xxHash64(filename), true).substr(0, 8);
+        }
+        m_output_names[filename] = stem + ".hpp";
+    }
+}
+
+inline const Generator::RecordEntry* Generator::findFieldRecord(const FieldMetaInfo& info) const
+{
+    auto type = detail::getElementType(info.raw_type);
+    for (const auto& type_ref : info.type_refs) {
+        auto iter = m_record_entries.find(type_ref);
+        // type_refs also lists template arguments, e.g. of a container holding the record.
+        if (iter != m_record_entries.end() && iter->second.info->full_name == type) {
+            return &iter->second;
+        }
+    }
+    return nullptr;
+}
+
+inline const Generator::RecordEntry* Generator::findBaseRecord(const RecordMetaInfo& info, size_t index) const
+{
+    if (index >= info.base_refs.size() || info.base_refs[index].empty()) {
+        return nullptr;
+    }
+    auto iter = m_record_entries.find(info.base_refs[index]);
+    return iter != m_record_entries.end() ? &iter->second : nullptr;
+}
+
+inline bool Generator::isHashable(const FieldMetaInfo& info) const
+{
+    if (info.is_bitwise_comparable || info.is_scalar) {
+        return true;
+    }
+    auto type = detail::getElementType(info.raw_type);
+    if (type.starts_with("std::") && (type.contains("::basic_string<") || type.contains("::basic_string_view<"))) {
+        return true;
+    }
+    const auto* entry = this->findFieldRecord(info);
+    return entry != nullptr && entry->is_hashed;
+}
+
+inline std::vector<const Generator::RecordEntry*> Generator::getHashDependencies(const std::string& filename) const
+{
+    std::vector<const RecordEntry*> dependencies;
+    for (const auto* record : m_records.at(filename)) {
+        if (!m_record_entries.at(detail::getRecordKey(*record)).is_hashed) {
+            continue;
+        }
+        std::vector<const RecordEntry*> used;
+        for (size_t i = 0; i < record->bases.size(); ++i) {
+            used.push_back(this->findBaseRecord(*record, i));
+        }
+        for (const auto& field : record->fields) {
+            used.push_back(detail::isHashed(field) ? this->findFieldRecord(field) : nullptr);
+        }
+        for (const auto* entry : used) {
+            if (entry && entry->is_hashed && entry->filename != filename
+                && std::find(dependencies.begin(), dependencies.end(), entry) == dependencies.end()) {
+                dependencies.push_back(entry);
+            }
+        }
+    }
+    return dependencies;
+}
+
+inline std::string Generator::getStamp(const std::string& filename) const
+{
+    // bump the version whenever the generated code changes for the same metadata.
+    std::string content = "xparse generator 2\n" + filename + "\n";
+    for (const auto* record : m_records.at(filename)) {
+        const auto& entry = m_record_entries.at(detail::getRecordKey(*record));
+        content += record->id + " " + record->hash + " " + (entry.is_hashed ? "1" : "0") + "\n";
+    }
+    for (const auto* entry : this->getHashDependencies(filename)) {
+        content += entry->info->id + " " + entry->info->hash + " " + m_output_names.at(entry->filename) + "\n";
+    }
+    return "// xparse stamp: " + llvm::utohexstr(llvm::xxHash64(content), true);
+}
+
+inline void Generator::generateFile(const std::string& filename, llvm::raw_ostream& outs)
+{
+    std::vector<const RecordMetaInfo*> hash_records;
+    for (const auto* record : m_records.at(filename)) {
+        if (m_record_entries.at(detail::getRecordKey(*record)).is_hashed) {
+            hash_records.push_back(record);
+        }
+    }
+    auto dependencies = this->getHashDependencies(filename);
+
+    outs << this->getStamp(filename) << "\n";
+    outs << "// This file is generated by xparse, do not edit.\n\n";
+    outs << "#pragma once\n\n";
+    outs << "#include <xparse/runtime.h>\n";
+    outs << "#include <xparse/soa.h>\n\n";
+    outs << "#include \"" << detail::escapeString(filename) << "\"\n";
+    for (const auto* entry : dependencies) {
+        outs << "#include \"" << m_output_names.at(entry->filename) << "\"\n";
+    }
+
+    // offsetof on non standard layout records is conditionally supported, but fine on every compiler we target.
+    outs << "\n#if defined(__GNUC__)\n"
+         << "#pragma GCC diagnostic push\n"
+         << "#pragma GCC diagnostic ignored \"-Winvalid-offsetof\"\n"
+         << "#endif\n\n";
+
+    outs << "namespace xparse {\n";
+    // hashed records may contain each other, so all specializations are declared before they are used.
+    // headers including each other skip the second include, so the ones used from them are declared too.
+    if (!hash_records.empty()) {
+        outs << "\n";
+    }
+    for (const auto* entry : dependencies) {
+        outs << "template <>\nstruct Hash<::" << entry->info->full_name << ">;\n";
+        outs << "template <>\nstruct Equal<::" << entry->info->full_name << ">;\n";
+    }
+    for (const auto* record : hash_records) {
+        outs << "template <>\nstruct Hash<::" << record->full_name << ">;\n";
+        outs << "template <>\nstruct Equal<::" << record->full_name << ">;\n";
+    }
+    for (const auto* record : m_records.at(filename)) {
+        this->generateRegistry(*record, outs);
+        if (findAnnotation(*record, "soa")) {
+            this->generateSoA(*record, outs);
+        }
+    }
+    for (const auto* record : hash_records) {
+        this->generateHash(*record, outs);
+    }
+    outs << "\n} // namespace xparse\n";
+
+    for (const auto* record : hash_records) {
+        this->generateHashOperators(*record, outs);
+    }
+
+    outs << "\n#if defined(__GNUC__)\n"
+         << "#pragma GCC diagnostic pop\n"
+         << "#endif\n";
+}
+
+inline void Generator::generate(llvm::raw_ostream& outs, llvm::StringRef directory)
+{
+    outs << "// This file is generated by xparse, do not edit.\n\n";
+    outs << "#pragma once\n\n";
+    for (const auto& filename : m_filenames) {
+        outs << "#include \"" << detail::escapeString(directory) << "/" << m_output_names.at(filename) << "\"\n";
+    }
+}
+
+inline void Generator::generateRegistry(const RecordMetaInfo& info, llvm::raw_ostream& outs)
+{
+    outs << "\ntemplate <>\n";
+    outs << "struct Reflect<::" << info.full_name << "> {\n";
+    outs << "    using Type = ::" << info.full_name << ";\n";
+
+    size_t field_count = 0;
+    for (const auto& field : info.fields) {
+        if (!detail::isAccessible(field)) {
+            continue;
+        }
+        if (field_count++ == 0) {
+            outs << "\n    static constexpr FieldDescriptor fields[] = {\n";
+        }
+
+        auto field_type = "decltype(Type::" + field.name + ")";
+        outs << "        { \"" << field.name << "\", typeId<" << field_type << ">(), ";
+        if (field.is_static) {
+            outs << "0, const_cast<void*>(static_cast<const void*>(&Type::" << field.name << ")), true, ";
+        } else {
+            outs << "offsetof(Type, " << field.name << "), nullptr, false, ";
+        }
+        outs << "std::is_const_v<" << field_type << "> },\n";
+    }
+    if (field_count == 0) {
+        outs << "\n    static constexpr const FieldDescriptor* fields = nullptr;\n";
+    } else {
+        outs << "    };\n";
+    }
+
+    // every method gets a thunk with a uniform signature, so calls need neither std::function nor allocation.
+    std::vector<const MethodMetaInfo*> methods;
+    for (const auto& method : info.methods) {
+        if (detail::isAccessible(method)) {
+            methods.push_back(&method);
+        }
+    }
+
+    for (size_t i = 0; i < methods.size(); ++i) {
+        const auto& method = *methods[i];
+
+        outs << "\n    static void invoke" << i << "(void* " << (method.is_static ? "/*object*/" : "object")
+             << ", void* const* " << (method.params.empty() ? "/*args*/" : "args") << ", void* result)\n";
+        outs << "    {\n";
+        outs << "        detail::invokeInto<" << method.ret_full_type << ">(result, [&]() -> " << method.ret_full_type << " {\n";
+        outs << "            return ";
+        if (method.is_static) {
+            outs << "Type::";
+        } else {
+            outs << "static_cast<" << (method.is_const ? "const Type" : "Type") << "*>(object)->";
+        }
+        outs << method.name << "(";
+        for (size_t j = 0; j < method.params.size(); ++j) {
+            outs << (j == 0 ? "" : ", ") << "detail::forwardArg<" << method.params[j].full_type << ">(args[" << j << "])";
+        }
+        outs << ");\n";
+        outs << "        });\n";
+        outs << "    }\n";
+
+        if (!method.params.empty()) {
+            outs << "    static constexpr TypeId params" << i << "[] = { ";
+            for (size_t j = 0; j < method.params.size(); ++j) {
+                outs << (j == 0 ? "" : ", ") << "typeId<" << method.params[j].full_type << ">()";
+            }
+            outs << " };\n";
+        }
+    }
+
+    if (methods.empty()) {
+        outs << "\n    static constexpr const MethodDescriptor* methods = nullptr;\n";
+    } else {
+        outs << "\n    static constexpr MethodDescriptor methods[] = {\n";
+        for (size_t i = 0; i < methods.size(); ++i) {
+            const auto& method = *methods[i];
+            outs << "        { \"" << method.name << "\", &invoke" << i << ", typeId<" << method.ret_full_type << ">(), ";
+            if (method.params.empty()) {
+                outs << "nullptr, 0, ";
+            } else {
+                outs << "params" << i << ", " << method.params.size() << ", ";
+            }
+            outs << (method.is_static ? "true" : "false") << ", " << (method.is_const ? "true" : "false") << " },\n";
+        }
+        outs << "    };\n";
+    }
+
+    outs << "\n    static constexpr RecordDescriptor record {\n";
+    outs << "        \"" << info.name << "\", \"" << info.full_name << "\", \"" << detail::escapeString(info.id) << "\",\n";
+    outs << "        typeId<Type>(), sizeof(Type), alignof(Type),\n";
+    outs << "        fields, " << field_count << ", methods, " << methods.size() << "\n";
+    outs << "    };\n";
+    outs << "};\n";
+}
+
+inline void Generator::generateSoA(const RecordMetaInfo& info, llvm::raw_ostream& outs)
+{
+    auto fields = detail::getColumnFields(info);
+    if (fields.empty()) {
+        return;
+    }
+
+    auto for_each_field = [&](auto&& fn) {
+        for (size_t i = 0; i < fields.size(); ++i) {
+            fn(i, *fields[i]);
+        }
+    };
+
+    outs << "\ntemplate <>\n";
+    outs << "class SoA<::" << info.full_name << "> : public SoAStorage<\n";
+    for_each_field([&](size_t i, const FieldMetaInfo& field) {
+        outs << "    decltype(::" << info.full_name << "::" << field.name << ")" << (i + 1 == fields.size() ? ">" : ",\n");
+    });
+    outs << " {\n";
+    outs << "public:\n";
+    outs << "    using Type = ::" << info.full_name << ";\n";
+    outs << "    using Storage = SoAStorage<";
+    for_each_field([&](size_t i, const FieldMetaInfo& field) {
+        outs << (i == 0 ? "" : ", ") << "decltype(Type::" << field.name << ")";
+    });
+    outs << ">;\n";
+
+    // row proxies, a view of one element as if it were stored as the original struct.
+    outs << "\n    struct ConstRef;\n";
+    for (bool is_const : { false, true }) {
+        const char* proxy_name = is_const ? "ConstRef" : "Ref";
+        outs << "\n    struct " << proxy_name << " {\n";
+        for_each_field([&](size_t /*i*/, const FieldMetaInfo& field) {
+            outs << "        " << (is_const ? "const " : "") << "decltype(Type::" << field.name << ")& " << field.name << ";\n";
+        });
+        outs << "\n        operator Type() const\n";
+        outs << "        {\n";
+        // the members are named after the fields, so a field may be named like a local or parameter.
+        outs << "            Type xparse_value;\n";
+        for_each_field([&](size_t /*i*/, const FieldMetaInfo& field) {
+            outs << "            xparse_value." << field.name << " = this->" << field.name << ";\n";
+        });
+        outs << "            return xparse_value;\n";
+        outs << "        }\n";
+        if (!is_const) {
+            outs << "\n        Ref& operator=(const Type& xparse_value)\n";
+            outs << "        {\n";
+            for_each_field([&](size_t /*i*/, const FieldMetaInfo& field) {
+                outs << "            this->" << field.name << " = xparse_value." << field.name << ";\n";
+            });
+            outs << "            return *this;\n";
+            outs << "        }\n";
+            outs << "\n        Ref& operator=(const Ref& xparse_other) { return *this = static_cast<Type>(xparse_other); }\n";
+            outs << "        Ref& operator=(const ConstRef& xparse_other) { return *this = static_cast<Type>(xparse_other); }\n";
+        }
+        outs << "    };\n";
+    }
+
+    outs << "\n";
+    for_each_field([&](size_t i, const FieldMetaInfo& field) {
+        auto column_name = detail::getColumnName(field.name);
+        outs << "    Column<decltype(Type::" << field.name << ")> " << column_name << "() noexcept { return this->column<" << i << ">(); }\n";
+        outs << "    Column<const decltype(Type::" << field.name << ")> " << column_name << "() const noexcept { return this->column<" << i << ">(); }\n";
+    });
+
+    auto write_row = [&](const char* proxy_name) {
+        outs << "        return " << proxy_name << " { ";
+        for_each_field([&](size_t i, const FieldMetaInfo& /*field*/) {
+            outs << (i == 0 ? "" : ", ") << "this->column<" << i << ">()[index]";
+        });
+        outs << " };\n";
+    };
+    outs << "\n    Ref operator[](std::size_t index) noexcept\n";
+    outs << "    {\n";
+    write_row("Ref");
+    outs << "    }\n";
+    outs << "\n    ConstRef operator[](std::size_t index) const noexcept\n";
+    outs << "    {\n";
+    write_row("ConstRef");
+    outs << "    }\n";
+
+    outs << "\n    void push(const Type& value)\n";
+    outs << "    {\n";
+    outs << "        this->emplace(";
+    for_each_field([&](size_t i, const FieldMetaInfo& field) {
+        outs << (i == 0 ? "" : ", ") << "value." << field.name;
+    });
+    outs << ");\n";
+    outs << "    }\n";
+
+    outs << "\n    void push(Type&& value)\n";
+    outs << "    {\n";
+    outs << "        this->emplace(";
+    for_each_field([&](size_t i, const FieldMetaInfo& field) {
+        outs << (i == 0 ? "" : ", ") << "std::move(value." << field.name << ")";
+    });
+    outs << ");\n";
+    outs << "    }\n";
+
+    outs << "\n    Type get(std::size_t index) const { return (*this)[index]; }\n";
+    outs << "    void set(std::size_t index, const Type& value) { (*this)[index] = value; }\n";
+
+    outs << "\n    static SoA fromAoS(const Type* values, std::size_t count)\n";
+    outs << "    {\n";
+    outs << "        SoA soa;\n";
+    outs << "        soa.reserve(count);\n";
+    outs << "        for (std::size_t i = 0; i < count; ++i) {\n";
+    outs << "            soa.push(values[i]);\n";
+    outs << "        }\n";
+    outs << "        return soa;\n";
+    outs << "    }\n";
+
+    outs << "\n    void toAoS(Type* values) const\n";
+    outs << "    {\n";
+    outs << "        for (std::size_t i = 0; i < this->size(); ++i) {\n";
+    outs << "            values[i] = this->get(i);\n";
+    outs << "        }\n";
+    outs << "    }\n";
+    outs << "};\n";
+}
+
+inline void Generator::generateHash(const RecordMetaInfo& info, llvm::raw_ostream& outs)
+{
+    auto groups = detail::getHashGroups(info);
+
+    outs << "\ntemplate <>\n";
+    outs << "struct Equal<::" << info.full_name << "> {\n";
+    outs << "    using Type = ::" << info.full_name << ";\n";
+
+    // the extracted layout may differ from the one this header is compiled for.
+    for (const auto& group : groups) {
+        if (!group.is_bitwise || group.fields.size() == 1) {
+            continue;
+        }
+        outs << "\n    static_assert(" << detail::getHashGroupSize(group) << " == ";
+        for (size_t i = 0; i < group.fields.size(); ++i) {
+            outs << (i == 0 ? "" : " + ") << "sizeof(Type::" << group.fields[i]->name << ")";
+        }
+        outs << ",\n        \"fields " << group.fields.front()->name << " to " << group.fields.back()->name
+             << " of " << info.full_name << " are compared as bytes but contain padding.\");\n";
+    }
+
+    outs << "\n    bool operator()(const Type& lhs, const Type& rhs) const\n";
+    outs << "    {\n";
+    outs << "        return ";
+    // inherited members are compared and hashed by the bases, which are hashed records themselves.
+    for (size_t i = 0; i < info.bases.size(); ++i) {
+        outs << (i == 0 ? "" : "\n            && ");
+        outs << "equalValue<::" << this->findBaseRecord(info, i)->info->full_name << ">(lhs, rhs)";
+    }
+    for (size_t i = 0; i < groups.size(); ++i) {
+        const auto& group = groups[i];
+        const auto& first = group.fields.front()->name;
+        outs << (i + info.bases.size() == 0 ? "" : "\n            && ");
+        if (group.is_bitwise) {
+            outs << "std::memcmp(&lhs." << first << ", &rhs." << first << ", " << detail::getHashGroupSize(group) << ") == 0";
+        } else {
+            outs << "equalValue(lhs." << first << ", rhs." << first << ")";
+        }
+    }
+    outs << ";\n";
+    outs << "    }\n";
+    outs << "};\n";
+
+    outs << "\ntemplate <>\n";
+    outs << "struct Hash<::" << info.full_name << "> {\n";
+    outs << "    using Type = ::" << info.full_name << ";\n";
+    outs << "\n    std::size_t operator()(const Type& value) const\n";
+    outs << "    {\n";
+    outs << "        std::size_t seed = 0;\n";
+    for (size_t i = 0; i < info.bases.size(); ++i) {
+        outs << "        seed = hashCombine(seed, hashValue<::" << this->findBaseRecord(info, i)->info->full_name << ">(value));\n";
+    }
+    for (const auto& group : groups) {
+        const auto& first = group.fields.front()->name;
+        if (group.is_bitwise) {
+            outs << "        seed = hashBytes(&value." << first << ", " << detail::getHashGroupSize(group) << ", seed);\n";
+        } else {
+            outs << "        seed = hashCombine(seed, hashValue(value." << first << "));\n";
+        }
+    }
+    outs << "        return seed;\n";
+    outs << "    }\n";
+    outs << "};\n";
+}
+
+/**
+ * @brief       std::hash and, for records declared at namespace scope, operator== and operator!= found by ADL.
+ * @note        `hash=no_std` or `hash=no_operator` on the record skip them, e.g. if they are written by hand.
+ */
+inline void Generator::generateHashOperators(const RecordMetaInfo& info, llvm::raw_ostream& outs)
+{
+    const auto* annotation = findAnnotation(info, "hash");
+
+    if (!detail::hasFlag(*annotation, "no_std")) {
+        outs << "\nnamespace std {\n";
+        outs << "\ntemplate <>\n";
+        outs << "struct hash<::" << info.full_name << "> {\n";
+        outs << "    size_t operator()(const ::" << info.full_name << "& value) const { return ::xparse::Hash<::"
+             << info.full_name << "> {}(value); }\n";
+        outs << "};\n";
+        outs << "\n} // namespace std\n";
+    }
+
+    bool has_operator = std::any_of(info.methods.begin(), info.methods.end(), [](const MethodMetaInfo& method) {
+        return method.name == "operator==";
+    });
+    if (info.is_nested || has_operator || detail::hasFlag(*annotation, "no_operator")) {
+        return;
+    }
+
+    if (!info.scope.empty()) {
+        outs << "\nnamespace " << info.scope << " {\n";
+    }
+    outs << "\ninline bool operator==(const ::" << info.full_name << "& lhs, const ::" << info.full_name << "& rhs)\n";
+    outs << "{\n";
+    outs << "    return ::xparse::Equal<::" << info.full_name << "> {}(lhs, rhs);\n";
+    outs << "}\n";
+    outs << "\ninline bool operator!=(const ::" << info.full_name << "& lhs, const ::" << info.full_name << "& rhs)\n";
+    outs << "{\n";
+    outs << "    return !(lhs == rhs);\n";
+    outs << "}\n";
+    if (!info.scope.empty()) {
+        outs << "\n} // namespace " << info.scope << "\n";
+    }
+}
+
+} // namespace xparse
+
+#endif // __XPARSE_GENERATOR_H__
@@ -0,0 +1,68 @@
+/**
+ * *****************************************************************************
+ * @file        loader.h
+ * @brief       Load project metadata written by xparse.
+ * @author      hsz (hszsoftware@qq.com)
+ * @date        2026-10-19
+ * @copyright   hszsoft
+ * *****************************************************************************
+ */
+
+#ifndef __XPARSE_LOADER_H__
+#define __XPARSE_LOADER_H__
+
+#include "compression.h"
+#include "meta.h"
+
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+namespace xparse {
+
+/**
+ * @brief       Parse project metadata, compressed metadata is decompressed first.
+ */
+inline llvm::Expected<ProjectMetaInfo> parseProjectMetaInfo(llvm::StringRef content)
+{
+    if (isCompressed(content)) {
+        auto decompressed = decompress(content);
+        if (!decompressed) {
+            return decompressed.takeError();
+        }
+        return parseProjectMetaInfo(*decompressed);
+    }
+
+    auto value = llvm::json::parse(content);
+    if (!value) {
+        return value.takeError();
+    }
+
+    const auto* files = value->getAsArray();
+    if (files == nullptr) {
+        return llvm::createStringError(llvm::inconvertibleErrorCode(), "project metadata is not an array");
+    }
+
+    ProjectMetaInfo metadata;
+    for (const auto& file : *files) {
+        FileMetaInfo file_metadata;
+        if (!Serializer::deserialize(file, file_metadata)) {
+            return llvm::createStringError(llvm::inconvertibleErrorCode(), "malformed file metadata");
+        }
+        auto filename = file_metadata.file;
+        metadata[filename] = std::move(file_metadata);
+    }
+    return metadata;
+}
+
+inline llvm::Expected<ProjectMetaInfo> loadProjectMetaInfo(llvm::StringRef filename)
+{
+    auto buffer = llvm::MemoryBuffer::getFile(filename);
+    if (!buffer) {
+        return llvm::createStringError(buffer.getError(), "failed to read \"%s\"", filename.str().c_str());
+    }
+    return parseProjectMetaInfo((*buffer)->getBuffer());
+}
+
+} // namespace xparse
+
+#endif // __XPARSE_LOADER_H__
@@ -1,7 +1,7 @@
 /**
  * *****************************************************************************
  * @file        log.h
- * @brief       
+ * @brief
  * @author      hsz (hszsoftware@qq.com)
  * @date        2024-10-24
  * @copyright   hszsoft
@@ -12,14 +12,160 @@
 #define __XPARSE_LOG_H__
 
 #include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/raw_ostream.h>
 
-#define XPARSE_LOG_INFO(MSG, ...) \
-    llvm::errs() << llvm::formatv("[info] {0}\n", llvm::formatv(MSG, __VA_ARGS__))
+#include <chrono>
 
-#define XPARSE_LOG_WARN(MSG, ...) \
-    llvm::errs() << llvm::formatv("[warn] {0}\n", llvm::formatv(MSG, __VA_ARGS__))
+#define XPARSE_LOG_LEVEL_DEBUG  0
+#define XPARSE_LOG_LEVEL_INFO   1
+#define XPARSE_LOG_LEVEL_WARN   2
+#define XPARSE_LOG_LEVEL_ERROR  3
 
-#define XPARSE_LOG_ERROR(MSG, ...) \
-    llvm::errs() << llvm::formatv("[error] {0}\n", llvm::formatv(MSG, __VA_ARGS__))
+// messages below this level are compiled out. Release builds keep debug messages too, so that --log-level=debug
+// works everywhere, the runtime check skips formatting them otherwise.
+#ifndef XPARSE_LOG_LEVEL
+#define XPARSE_LOG_LEVEL XPARSE_LOG_LEVEL_DEBUG
+#endif
+
+// arguments are only formatted if the level is enabled at runtime.
+#define XPARSE_LOG(LEVEL, ...)                                                      \
+    do {                                                                            \
+        auto& xparse_logger = ::xparse::Logger::instance();                         \
+        if (xparse_logger.isEnabled(LEVEL)) {                                       \
+            xparse_logger.log(LEVEL, llvm::formatv(__VA_ARGS__));                   \
+        }                                                                           \
+    } while (false)
+
+#if XPARSE_LOG_LEVEL <= XPARSE_LOG_LEVEL_DEBUG
+#define XPARSE_LOG_DEBUG(...) XPARSE_LOG(::xparse::LogLevel::kDebug, __VA_ARGS__)
+#else
+#define XPARSE_LOG_DEBUG(...) ((void)0)
+#endif
+
+#if XPARSE_LOG_LEVEL <= XPARSE_LOG_LEVEL_INFO
+#define XPARSE_LOG_INFO(...) XPARSE_LOG(::xparse::LogLevel::kInfo, __VA_ARGS__)
+#else
+#define XPARSE_LOG_INFO(...) ((void)0)
+#endif
+
+#if XPARSE_LOG_LEVEL <= XPARSE_LOG_LEVEL_WARN
+#define XPARSE_LOG_WARN(...) XPARSE_LOG(::xparse::LogLevel::kWarn, __VA_ARGS__)
+#else
+#define XPARSE_LOG_WARN(...) ((void)0)
+#endif
+
+#define XPARSE_LOG_ERROR(...) XPARSE_LOG(::xparse::LogLevel::kError, __VA_ARGS__)
+
+namespace xparse {
+
+enum class LogLevel : std::uint8_t {
+    kDebug = XPARSE_LOG_LEVEL_DEBUG,
+    kInfo = XPARSE_LOG_LEVEL_INFO,
+    kWarn = XPARSE_LOG_LEVEL_WARN,
+    kError = XPARSE_LOG_LEVEL_ERROR,
+    kOff
+};
+
+enum class LogFormat : std::uint8_t {
+    kText,
+    kJson
+};
+
+/**
+ * @brief       Buffers log lines and writes them to stderr in batches.
+ * @note        The buffer is written when it grows large, on errors, on flush() and at exit.
+ *              The json format writes one object per line with level, elapsed milliseconds,
+ *              message and optional structured fields.
+ */
+class Logger {
+public:
+    static Logger& instance()
+    {
+        static Logger logger;
+        return logger;
+    }
+
+    ~Logger() { this->flush(); }
+
+    void setLevel(LogLevel level) { m_level = level; }
+    void setFormat(LogFormat format) { m_format = format; }
+
+    bool isEnabled(LogLevel level) const { return level >= m_level && level != LogLevel::kOff; }
+
+    template <typename Message>
+    void log(LogLevel level, Message&& message, llvm::json::Object fields = {});
+
+    void flush();
+
+private:
+    Logger()
+        : m_outs(m_buffer)
+        , m_start(std::chrono::steady_clock::now())
+    {
+        // make sure stderr outlives the logger, which flushes on destruction.
+        llvm::errs();
+    }
+
+    static const char* getLevelName(LogLevel level);
+
+    static constexpr size_t kFlushThreshold = 64 * 1024;
+
+    std::string                             m_buffer;
+    llvm::raw_string_ostream                m_outs;
+    std::chrono::steady_clock::time_point   m_start;
+    LogLevel                                m_level = LogLevel::kInfo;
+    LogFormat                               m_format = LogFormat::kText;
+};
+
+template <typename Message>
+inline void Logger::log(LogLevel level, Message&& message, llvm::json::Object fields)
+{
+    if (m_format == LogFormat::kText) {
+        m_outs << "[" << getLevelName(level) << "] " << message << "\n";
+    } else {
+        std::string text;
+        llvm::raw_string_ostream text_outs(text);
+        text_outs << message;
+
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start);
+        fields["level"] = getLevelName(level);
+        fields["time"] = elapsed.count();
+        fields["message"] = std::move(text_outs.str());
+        m_outs << llvm::json::Value(std::move(fields)) << "\n";
+    }
+
+    if (level >= LogLevel::kError || m_buffer.size() >= kFlushThreshold) {
+        this->flush();
+    }
+}
+
+inline void Logger::flush()
+{
+    m_outs.flush();
+    if (!m_buffer.empty()) {
+        llvm::errs() << m_buffer;
+        llvm::errs().flush();
+        m_buffer.clear();
+    }
+}
+
+inline const char* Logger::getLevelName(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::kDebug:
+        return "debug";
+    case LogLevel::kInfo:
+        return "info";
+    case LogLevel::kWarn:
+        return "warn";
+    case LogLevel::kError:
+        return "error";
+    default:
+        return "off";
+    }
+}
+
+} // namespace xparse
 
 #endif
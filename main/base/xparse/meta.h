@@ -25,6 +25,61 @@
 
 namespace xparse {
 
+/**
+ * @brief       A typed value of an annotation, evaluated at extraction time.
+ * @note        `kind` is one of "bool", "int", "float", "string" and "enum". An enum value stores
+ *              the full name of the constant in `string_value`, its value in `int_value` and the id
+ *              of the enum in `enum_ref`.
+ */
+struct AttrValueMetaInfo {
+    std::string kind;
+    bool bool_value = false;
+    int64_t int_value = 0;
+    double float_value = 0.0;
+    std::string string_value;
+    std::string enum_ref;
+};
+
+XPARSE_SERIALIZE_OBJECT(AttrValueMetaInfo)
+{
+    // only the member matching the kind is written, always as "value".
+    XPARSE_SERIALIZE_ATTR(kind);
+    if (ins.kind == "bool") {
+        visitor.attribute("value", ins.bool_value);
+    } else if (ins.kind == "int") {
+        visitor.attribute("value", ins.int_value);
+    } else if (ins.kind == "float") {
+        visitor.attribute("value", ins.float_value);
+    } else {
+        visitor.attribute("value", ins.string_value);
+    }
+    if (ins.kind == "enum") {
+        XPARSE_SERIALIZE_ATTR(int_value);
+        XPARSE_SERIALIZE_ATTR(enum_ref);
+    }
+}
+
+/**
+ * @brief       Structured form of a `clang::annotate` attribute.
+ * @note        The annotation string is `key`, `key=values` or `key:values`, where values are separated
+ *              by commas and each is `true`, `false`, an integer, a floating point number, a quoted string
+ *              or otherwise a bare string. Non-finite numbers such as `nan` or `inf` and integers outside
+ *              of int64 are kept as strings, since json cannot represent them exactly. Arguments of the
+ *              attribute, e.g. `annotate("range", 0, 100)`, are evaluated as constant expressions and
+ *              appended to the values.
+ *              A key without values is a flag.
+ */
+struct AttrMetaInfo {
+    std::string key;
+    std::vector<AttrValueMetaInfo> values;
+};
+
+XPARSE_SERIALIZE_OBJECT(AttrMetaInfo)
+{
+    XPARSE_SERIALIZE_ATTR(key);
+    XPARSE_SERIALIZE_ATTR(values);
+}
+
 /**
  * @brief       Base of all meta info.
  * 
@@ -33,6 +88,7 @@ struct MetaInfo {
     std::string name;
     std::string full_name;
     std::vector<std::string> attrs;
+    std::vector<AttrMetaInfo> annotations;
     std::string access;
     std::string comment;
 };
@@ -42,10 +98,21 @@ XPARSE_SERIALIZE_OBJECT(MetaInfo)
     XPARSE_SERIALIZE_ATTR(name);
     XPARSE_SERIALIZE_ATTR(full_name);
     XPARSE_SERIALIZE_ATTR(attrs);
+    XPARSE_SERIALIZE_ATTR(annotations);
     XPARSE_SERIALIZE_ATTR(access);
     XPARSE_SERIALIZE_ATTR(comment);
 }
 
+inline const AttrMetaInfo* findAnnotation(const MetaInfo& info, const std::string& key)
+{
+    for (const auto& annotation : info.annotations) {
+        if (annotation.key == key) {
+            return &annotation;
+        }
+    }
+    return nullptr;
+}
+
 /**
  * @brief       Store type info of variables.
  * 
@@ -53,6 +120,11 @@ XPARSE_SERIALIZE_OBJECT(MetaInfo)
 struct ValueMetaInfo : MetaInfo {
     std::string type;
     std::string raw_type;
+    /// fully qualified spelling usable from generated code.
+    std::string full_type;
+    /// ids of the reflected records and enums named by the type, looking through
+    /// pointers, references, arrays, function signatures and template arguments.
+    std::vector<std::string> type_refs;
     std::string default_value;
 };
 
@@ -61,39 +133,68 @@ XPARSE_SERIALIZE_OBJECT(ValueMetaInfo)
     XPARSE_SERIALIZE_ATTR_FROM_OBJECT(MetaInfo);
     XPARSE_SERIALIZE_ATTR(type);
     XPARSE_SERIALIZE_ATTR(raw_type);
+    XPARSE_SERIALIZE_ATTR(full_type);
+    XPARSE_SERIALIZE_ATTR(type_refs);
     XPARSE_SERIALIZE_ATTR(default_value);
 }
 
 struct FieldMetaInfo : ValueMetaInfo {
     bool is_static = false;
+    bool is_bitfield = false;
+    /// byte offset in the record and size of the type, both 0 for static fields and bitfields.
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    /// integers, enums, pointers and arrays of them without padding bits, whose equality is that of their bytes.
+    bool is_bitwise_comparable = false;
+    /// arithmetic, enum and pointer types and arrays of them, which std::hash supports.
+    bool is_scalar = false;
 };
 
 XPARSE_SERIALIZE_OBJECT(FieldMetaInfo)
 {
     XPARSE_SERIALIZE_ATTR_FROM_OBJECT(ValueMetaInfo);
     XPARSE_SERIALIZE_ATTR(is_static);
+    XPARSE_SERIALIZE_ATTR(is_bitfield);
+    XPARSE_SERIALIZE_ATTR(offset);
+    XPARSE_SERIALIZE_ATTR(size);
+    XPARSE_SERIALIZE_ATTR(is_bitwise_comparable);
+    XPARSE_SERIALIZE_ATTR(is_scalar);
 }
 
 struct FunctionMetaInfo : MetaInfo {
+    std::string id;
+    std::string hash;
     std::string ret_type;
     std::string ret_raw_type;
+    std::string ret_full_type;
+    std::vector<std::string> ret_type_refs;
     std::vector<ValueMetaInfo> params;
     bool is_static;
+    bool is_deleted = false;
 };
 
 XPARSE_SERIALIZE_OBJECT(FunctionMetaInfo)
 {
     XPARSE_SERIALIZE_ATTR_FROM_OBJECT(MetaInfo);
+    XPARSE_SERIALIZE_ATTR(id);
+    XPARSE_SERIALIZE_ATTR(hash);
     XPARSE_SERIALIZE_ATTR(ret_type);
     XPARSE_SERIALIZE_ATTR(ret_raw_type);
+    XPARSE_SERIALIZE_ATTR(ret_full_type);
+    XPARSE_SERIALIZE_ATTR(ret_type_refs);
     XPARSE_SERIALIZE_ATTR(params);
     XPARSE_SERIALIZE_ATTR(is_static);
+    XPARSE_SERIALIZE_ATTR(is_deleted);
 }
 
 struct MethodMetaInfo : FunctionMetaInfo {
     bool is_virtual = false;
     bool is_pure_virtual = false;
     bool is_override = false;
+    bool is_final = false;
+    bool is_const = false;
+    /// ids of the methods directly overridden by this one.
+    std::vector<std::string> overrides;
 };
 
 XPARSE_SERIALIZE_OBJECT(MethodMetaInfo)
@@ -102,24 +203,53 @@ XPARSE_SERIALIZE_OBJECT(MethodMetaInfo)
     XPARSE_SERIALIZE_ATTR(is_virtual);
     XPARSE_SERIALIZE_ATTR(is_pure_virtual);
     XPARSE_SERIALIZE_ATTR(is_override);
+    XPARSE_SERIALIZE_ATTR(is_final);
+    XPARSE_SERIALIZE_ATTR(is_const);
+    XPARSE_SERIALIZE_ATTR(overrides);
 }
 
 /**
  * @brief       Store meta info for class, struct and union.
- * 
+ * @note        `id` is the clang USR of the declaration, which is what every `*_refs` entry points to.
+ *              `hash` changes whenever the declaration or any metadata extracted from it changes.
+ *              `base_refs` is parallel to `bases`, an empty string marks a base that is not reflected.
+ *              `scope` is the enclosing namespace, empty for the global namespace and nested records.
+ *              `is_default_constructible` is true if a public default constructor exists and is not deleted.
  */
 struct RecordMetaInfo : MetaInfo {
+    std::string id;
+    std::string hash;
     std::vector<std::string> bases;
+    std::vector<std::string> base_refs;
     std::vector<FieldMetaInfo> fields;
     std::vector<MethodMetaInfo> methods;
+    bool is_polymorphic = false;
+    bool is_abstract = false;
+    bool is_final = false;
+    bool is_default_constructible = false;
+    std::string scope;
+    bool is_nested = false;
+    uint64_t size = 0;
+    uint64_t align = 0;
 };
 
 XPARSE_SERIALIZE_OBJECT(RecordMetaInfo)
 {
     XPARSE_SERIALIZE_ATTR_FROM_OBJECT(MetaInfo);
+    XPARSE_SERIALIZE_ATTR(id);
+    XPARSE_SERIALIZE_ATTR(hash);
     XPARSE_SERIALIZE_ATTR(bases);
+    XPARSE_SERIALIZE_ATTR(base_refs);
     XPARSE_SERIALIZE_ATTR(fields);
     XPARSE_SERIALIZE_ATTR(methods);
+    XPARSE_SERIALIZE_ATTR(is_polymorphic);
+    XPARSE_SERIALIZE_ATTR(is_abstract);
+    XPARSE_SERIALIZE_ATTR(is_final);
+    XPARSE_SERIALIZE_ATTR(is_default_constructible);
+    XPARSE_SERIALIZE_ATTR(scope);
+    XPARSE_SERIALIZE_ATTR(is_nested);
+    XPARSE_SERIALIZE_ATTR(size);
+    XPARSE_SERIALIZE_ATTR(align);
 }
 
 struct EnumConstantMetaInfo : MetaInfo {
@@ -133,12 +263,16 @@ XPARSE_SERIALIZE_OBJECT(EnumConstantMetaInfo)
 }
 
 struct EnumMetaInfo : MetaInfo {
+    std::string id;
+    std::string hash;
     std::vector<EnumConstantMetaInfo> constants;
 };
 
 XPARSE_SERIALIZE_OBJECT(EnumMetaInfo)
 {
     XPARSE_SERIALIZE_ATTR_FROM_OBJECT(MetaInfo);
+    XPARSE_SERIALIZE_ATTR(id);
+    XPARSE_SERIALIZE_ATTR(hash);
     XPARSE_SERIALIZE_ATTR(constants);
 }
 
@@ -0,0 +1,122 @@
+/**
+ * *****************************************************************************
+ * @file        path_cache.h
+ * @brief       Resolve source locations to canonical file paths once per file.
+ * @author      hsz (hszsoftware@qq.com)
+ * @date        2026-10-19
+ * @copyright   hszsoft
+ * *****************************************************************************
+ */
+
+#ifndef __XPARSE_PATH_CACHE_H__
+#define __XPARSE_PATH_CACHE_H__
+
+#include <clang/Basic/SourceManager.h>
+#include <clang/Tooling/Tooling.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Support/FileSystem/UniqueID.h>
+
+#include <filesystem>
+#include <map>
+
+namespace xparse {
+
+/**
+ * @brief       Memoizes the canonical path of every file a declaration can come from.
+ * @note        Canonicalizing a path costs several syscalls, which dominate extraction on network file systems.
+ *              Results are looked up by FileID within a translation unit and by file identity across translation
+ *              units, so every header is resolved once per run. Files renamed by #line are looked up by their
+ *              presumed name instead, since one FileID can then map to several names.
+ */
+class PathCache {
+public:
+    /**
+     * @brief       FileIDs are only meaningful within one SourceManager, call this before each translation unit.
+     */
+    void beginTranslationUnit(const clang::SourceManager& source_manager)
+    {
+        m_source_manager = &source_manager;
+        m_file_ids.clear();
+    }
+
+    /**
+     * @brief       Get the canonical path of the file containing location, empty if it has none.
+     */
+    const std::string& getFilename(clang::SourceLocation location);
+
+    size_t getHitCount() const { return m_hit_count; }
+    size_t getMissCount() const { return m_miss_count; }
+
+private:
+    const std::string& resolve(llvm::StringRef filename);
+
+    const clang::SourceManager*                         m_source_manager = nullptr;
+    llvm::DenseMap<clang::FileID, const std::string*>   m_file_ids;
+    std::map<llvm::sys::fs::UniqueID, const std::string*> m_unique_ids;
+    // owns the resolved paths, entries never move so the maps above can point into it.
+    llvm::StringMap<std::string>                        m_paths;
+    size_t                                              m_hit_count = 0;
+    size_t                                              m_miss_count = 0;
+};
+
+inline const std::string& PathCache::getFilename(clang::SourceLocation location)
+{
+    static const std::string s_empty;
+    if (m_source_manager == nullptr || location.isInvalid()) {
+        return s_empty;
+    }
+
+    auto file_location = m_source_manager->getFileLoc(location);
+    auto file_id = m_source_manager->getFileID(file_location);
+    auto file_id_iter = m_file_ids.find(file_id);
+    if (file_id_iter != m_file_ids.end()) {
+        ++m_hit_count;
+        return *file_id_iter->second;
+    }
+
+    auto presumed_location = m_source_manager->getPresumedLoc(file_location);
+    if (presumed_location.isInvalid()) {
+        return s_empty;
+    }
+
+    const auto& entry = m_source_manager->getSLocEntry(file_id);
+    const auto* file_entry = m_source_manager->getFileEntryForID(file_id);
+    if (file_entry == nullptr || (entry.isFile() && entry.getFile().hasLineDirectives())) {
+        return this->resolve(presumed_location.getFilename());
+    }
+
+    const std::string* filename = nullptr;
+    auto unique_id_iter = m_unique_ids.find(file_entry->getUniqueID());
+    if (unique_id_iter != m_unique_ids.end()) {
+        ++m_hit_count;
+        filename = unique_id_iter->second;
+    } else {
+        filename = &this->resolve(presumed_location.getFilename());
+        m_unique_ids.emplace(file_entry->getUniqueID(), filename);
+    }
+    m_file_ids[file_id] = filename;
+    return *filename;
+}
+
+inline const std::string& PathCache::resolve(llvm::StringRef filename)
+{
+    // relative names depend on the working directory of the current compile command.
+    auto absolute_path = clang::tooling::getAbsolutePath(filename);
+    auto [iter, inserted] = m_paths.try_emplace(absolute_path);
+    if (!inserted) {
+        ++m_hit_count;
+        return iter->second;
+    }
+
+    ++m_miss_count;
+    std::error_code error_code;
+    auto canonical_path = std::filesystem::canonical(std::filesystem::path(absolute_path), error_code);
+    // #line may name a file that does not exist.
+    iter->second = error_code ? absolute_path : canonical_path.string();
+    return iter->second;
+}
+
+} // namespace xparse
+
+#endif // __XPARSE_PATH_CACHE_H__
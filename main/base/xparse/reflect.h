@@ -13,15 +13,25 @@
 
 #include "log.h"
 #include "meta.h"
+#include "path_cache.h"
 
 #include <clang/AST/ASTConsumer.h>
 #include <clang/AST/Attr.h>
+#include <clang/AST/DeclTemplate.h>
+#include <clang/AST/ODRHash.h>
+#include <clang/AST/QualTypeNames.h>
+#include <clang/AST/RecordLayout.h>
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Frontend/FrontendAction.h>
+#include <clang/Index/USRGeneration.h>
 #include <clang/Tooling/Tooling.h>
+#include <llvm/ADT/StringExtras.h>
 #include <llvm/Support/FormatVariadic.h>
+#include <llvm/Support/xxhash.h>
 
-#include <filesystem>
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
 
 namespace xparse {
 
@@ -71,12 +81,168 @@ namespace detail {
         return false;
     }
 
+    inline AttrValueMetaInfo parseAnnotationValue(llvm::StringRef text)
+    {
+        AttrValueMetaInfo value;
+        text = text.trim();
+
+        if (text.size() >= 2 && text.front() == '"' && text.back() == '"') {
+            value.kind = "string";
+            auto quoted = text.drop_front().drop_back();
+            for (size_t i = 0; i < quoted.size(); ++i) {
+                if (quoted[i] == '\\' && i + 1 < quoted.size()) {
+                    ++i;
+                }
+                value.string_value += quoted[i];
+            }
+        } else if (text == "true" || text == "false") {
+            value.kind = "bool";
+            value.bool_value = text == "true";
+        } else if (!text.getAsInteger(0, value.int_value)) {
+            value.kind = "int";
+        } else if (llvm::APInt wide_value; !text.getAsInteger(0, wide_value)) {
+            // an integer outside of int64 would lose precision as a float.
+            value.kind = "string";
+            value.string_value = text.str();
+        } else if (!text.getAsDouble(value.float_value) && std::isfinite(value.float_value)) {
+            value.kind = "float";
+        } else {
+            value.kind = "string";
+            value.string_value = text.str();
+        }
+        return value;
+    }
+
+    /**
+     * @brief       Parse the string part of an annotation, see AttrMetaInfo for the grammar.
+     */
+    inline void parseAnnotation(llvm::StringRef annotation, AttrMetaInfo& info)
+    {
+        auto separator = annotation.find_first_of("=:");
+        info.key = annotation.substr(0, separator).trim().str();
+        if (separator == llvm::StringRef::npos) {
+            return;
+        }
+
+        // split on commas outside of quotes.
+        auto values = annotation.substr(separator + 1);
+        bool quoted = false;
+        size_t begin = 0;
+        for (size_t i = 0; i <= values.size(); ++i) {
+            if (i == values.size() || (values[i] == ',' && !quoted)) {
+                info.values.push_back(parseAnnotationValue(values.slice(begin, i)));
+                begin = i + 1;
+            } else if (values[i] == '"' && (i == 0 || values[i - 1] != '\\')) {
+                quoted = !quoted;
+            }
+        }
+    }
+
+    inline std::string getDeclId(const clang::Decl* decl)
+    {
+        llvm::SmallString<128> usr;
+        if (clang::index::generateUSRForDecl(decl, usr)) {
+            return {};
+        }
+        return usr.str().str();
+    }
+
+    /**
+     * @brief       Collect ids of the reflected records and enums named by a type.
+     *
+     * @param       type
+     * @param       refs    deduplicated, in order of first appearance.
+     */
+    inline void collectTypeRefs(clang::QualType type, std::vector<std::string>& refs)
+    {
+        if (type.isNull()) {
+            return;
+        }
+
+        const auto* type_ptr = type.getCanonicalType().getTypePtr();
+
+        // pointers, references, member pointers and blocks.
+        if (auto pointee = type_ptr->getPointeeType(); !pointee.isNull()) {
+            if (const auto* member_ptr = llvm::dyn_cast<clang::MemberPointerType>(type_ptr)) {
+                collectTypeRefs(clang::QualType(member_ptr->getClass(), 0), refs);
+            }
+            collectTypeRefs(pointee, refs);
+            return;
+        }
+
+        if (const auto* array = llvm::dyn_cast<clang::ArrayType>(type_ptr)) {
+            collectTypeRefs(array->getElementType(), refs);
+            return;
+        }
+
+        if (const auto* function = llvm::dyn_cast<clang::FunctionProtoType>(type_ptr)) {
+            collectTypeRefs(function->getReturnType(), refs);
+            for (auto param_type : function->getParamTypes()) {
+                collectTypeRefs(param_type, refs);
+            }
+            return;
+        }
+
+        auto* tag_decl = type_ptr->getAsTagDecl();
+        if (tag_decl == nullptr) {
+            return;
+        }
+
+        if (const auto* specialization = llvm::dyn_cast<clang::ClassTemplateSpecializationDecl>(tag_decl)) {
+            for (const auto& arg : specialization->getTemplateArgs().asArray()) {
+                if (arg.getKind() == clang::TemplateArgument::Type) {
+                    collectTypeRefs(arg.getAsType(), refs);
+                } else if (arg.getKind() == clang::TemplateArgument::Pack) {
+                    for (const auto& pack_arg : arg.pack_elements()) {
+                        if (pack_arg.getKind() == clang::TemplateArgument::Type) {
+                            collectTypeRefs(pack_arg.getAsType(), refs);
+                        }
+                    }
+                }
+            }
+        }
+
+        // annotations live on the definition, forward declarations are not marked.
+        auto* definition = tag_decl->getDefinition();
+        if (definition == nullptr || !isMarked(definition)) {
+            return;
+        }
+
+        auto id = getDeclId(definition);
+        if (!id.empty() && std::find(refs.begin(), refs.end(), id) == refs.end()) {
+            refs.push_back(std::move(id));
+        }
+    }
+
+    /**
+     * @brief       Combine the ODR hash of a decl with the metadata extracted from it.
+     * @note        The ODR hash ignores annotations and comments, which are part of our output.
+     *              Must be called before `info.hash` is assigned.
+     */
+    template <typename T>
+    inline std::string getStructuralHash(unsigned odr_hash, const T& info)
+    {
+        std::string content;
+        llvm::raw_string_ostream content_outs(content);
+        content_outs << odr_hash;
+        llvm::json::OStream json_outs(content_outs);
+        Serializer::serialize(json_outs, info);
+        content_outs.flush();
+        return llvm::utohexstr(llvm::xxh3_64bits(llvm::arrayRefFromStringRef(content)), true);
+    }
+
 } // namespace detail
 
 class ReflectASTConsumer : public clang::ASTConsumer {
 public:
-    ReflectASTConsumer(ProjectMetaInfo& metadata)
+    /**
+     * @param       extracted_ids   ids of the entities extracted so far, shared by all translation units since
+     *                              headers are parsed once per translation unit including them.
+     */
+    ReflectASTConsumer(ProjectMetaInfo& metadata, PathCache& path_cache, std::unordered_set<std::string>& extracted_ids)
         : m_metadata(&metadata)
+        , m_path_cache(&path_cache)
+        , m_extracted_ids(&extracted_ids)
     {
     }
 
@@ -99,6 +265,7 @@ protected:
     void handleDecl(clang::NamespaceDecl* decl);
 
     HandleResult handleDecl(clang::NamedDecl* decl, MetaInfo& info);
+    void handleAnnotation(clang::AnnotateAttr* annotate, AttrMetaInfo& info);
     HandleResult handleDecl(clang::ValueDecl* decl, ValueMetaInfo& info);
     HandleResult handleDecl(clang::FunctionDecl* decl, FunctionMetaInfo& info);
     HandleResult handleDecl(clang::ParmVarDecl* decl, ValueMetaInfo& info);
@@ -114,13 +281,16 @@ protected:
     HandleResult handleDecl(clang::EnumConstantDecl* decl, EnumConstantMetaInfo& info);
 
 private:
-    ProjectMetaInfo*    m_metadata;
-    clang::ASTContext*  m_context;
+    ProjectMetaInfo*                    m_metadata;
+    PathCache*                          m_path_cache;
+    std::unordered_set<std::string>*    m_extracted_ids;
+    clang::ASTContext*                  m_context;
 };
 
 inline void ReflectASTConsumer::HandleTranslationUnit(clang::ASTContext& ctx)
 {
     m_context = &ctx;
+    m_path_cache->beginTranslationUnit(ctx.getSourceManager());
     auto* tu_decl = ctx.getTranslationUnitDecl();
     for (auto* decl : tu_decl->decls()) {
         auto* named_decl = llvm::dyn_cast<clang::NamedDecl>(decl);
@@ -153,14 +323,7 @@ inline void ReflectASTConsumer::HandleTranslationUnit(clang::ASTContext& ctx)
 
 inline std::string ReflectASTConsumer::getDeclFilename(clang::NamedDecl* decl)
 {
-    std::string filename;
-
-    auto location = m_context->getSourceManager().getPresumedLoc(decl->getLocation());
-    if (!location.isInvalid()) {
-        std::filesystem::path filepath(clang::tooling::getAbsolutePath(location.getFilename()));
-        filename = std::filesystem::canonical(filepath).string();
-    }
-    return filename;
+    return m_path_cache->getFilename(decl->getLocation());
 }
 
 inline void ReflectASTConsumer::handleDecl(clang::NamespaceDecl* decl)
@@ -203,6 +366,10 @@ inline ReflectASTConsumer::HandleResult ReflectASTConsumer::handleDecl(clang::Na
     for (auto* annotate : decl->specific_attrs<clang::AnnotateAttr>()) {
         if (annotate->getAnnotation() != "__reflect__") {
             info.attrs.push_back(annotate->getAnnotation().str());
+
+            AttrMetaInfo annotation_info;
+            this->handleAnnotation(annotate, annotation_info);
+            info.annotations.push_back(annotation_info);
         }
     }
 
@@ -214,6 +381,76 @@ inline ReflectASTConsumer::HandleResult ReflectASTConsumer::handleDecl(clang::Na
     return kSuccess;
 }
 
+inline void ReflectASTConsumer::handleAnnotation(clang::AnnotateAttr* annotate, AttrMetaInfo& info)
+{
+    detail::parseAnnotation(annotate->getAnnotation(), info);
+
+    for (auto* arg : annotate->args()) {
+        AttrValueMetaInfo value;
+
+        // string literals are kept as they are by sema, everything else has been checked to be constant.
+        const auto* literal = llvm::dyn_cast<clang::StringLiteral>(arg->IgnoreParenImpCasts());
+        if (literal && literal->getCharByteWidth() == 1) {
+            value.kind = "string";
+            value.string_value = literal->getString().str();
+            info.values.push_back(value);
+            continue;
+        }
+
+        clang::Expr::EvalResult result;
+        if (!arg->EvaluateAsRValue(result, *m_context)) {
+            XPARSE_LOG_WARN("annotation \"{0}\" has an argument that is not a constant, ignored.", info.key);
+            continue;
+        }
+
+        auto type = arg->getType().getCanonicalType();
+        const auto& evaluated = result.Val;
+        if (evaluated.isInt() && !type->isBooleanType() && !evaluated.getInt().isRepresentableByInt64()) {
+            // e.g. unsigned values above INT64_MAX, kept exactly instead of truncated.
+            value.kind = "string";
+            value.string_value = llvm::toString(evaluated.getInt(), 10);
+        } else if (const auto* enum_type = type->getAs<clang::EnumType>(); enum_type && evaluated.isInt()) {
+            auto* enum_decl = enum_type->getDecl();
+            value.kind = "enum";
+            value.int_value = evaluated.getInt().getExtValue();
+            value.enum_ref = detail::getDeclId(enum_decl);
+            for (auto* constant_decl : enum_decl->enumerators()) {
+                if (llvm::APSInt::isSameValue(constant_decl->getInitVal(), evaluated.getInt())) {
+                    value.string_value = constant_decl->getQualifiedNameAsString();
+                    break;
+                }
+            }
+        } else if (type->isBooleanType() && evaluated.isInt()) {
+            value.kind = "bool";
+            value.bool_value = evaluated.getInt().getBoolValue();
+        } else if (evaluated.isInt()) {
+            value.kind = "int";
+            value.int_value = evaluated.getInt().getExtValue();
+        } else if (evaluated.isFloat()) {
+            bool loses_info = false;
+            auto float_value = evaluated.getFloat();
+            float_value.convert(llvm::APFloat::IEEEdouble(), llvm::APFloat::rmNearestTiesToEven, &loses_info);
+            if (float_value.isFinite()) {
+                value.kind = "float";
+                value.float_value = float_value.convertToDouble();
+            } else {
+                // spelled like the annotation string would be, json has no number for them.
+                value.kind = "string";
+                value.string_value = float_value.isNaN() ? "nan" : (float_value.isNegative() ? "-inf" : "inf");
+            }
+        } else if (const auto* base = evaluated.isLValue() ? evaluated.getLValueBase().dyn_cast<const clang::Expr*>() : nullptr;
+                   base && llvm::isa<clang::StringLiteral>(base)) {
+            // e.g. a constexpr const char* pointing to a literal.
+            value.kind = "string";
+            value.string_value = llvm::cast<clang::StringLiteral>(base)->getString().str();
+        } else {
+            XPARSE_LOG_WARN("annotation \"{0}\" has an argument of unsupported type \"{1}\", ignored.", info.key, type.getAsString());
+            continue;
+        }
+        info.values.push_back(value);
+    }
+}
+
 inline ReflectASTConsumer::HandleResult ReflectASTConsumer::handleDecl(clang::ValueDecl* decl, ValueMetaInfo& info)
 {
     if (!detail::isValid(decl)) {
@@ -226,6 +463,8 @@ inline ReflectASTConsumer::HandleResult ReflectASTConsumer::handleDecl(clang::Va
 
     info.type = decl->getType().getAsString();
     info.raw_type = decl->getType().getCanonicalType().getAsString();
+    info.full_type = clang::TypeName::getFullyQualifiedName(decl->getType(), *m_context, m_context->getPrintingPolicy(), true);
+    detail::collectTypeRefs(decl->getType(), info.type_refs);
 
     return kSuccess;
 }
@@ -240,8 +479,13 @@ inline ReflectASTConsumer::HandleResult ReflectASTConsumer::handleDecl(clang::Fu
         return kFailure;
     }
 
+    if (info.id.empty()) {
+        info.id = detail::getDeclId(decl);
+    }
     info.ret_type = decl->getReturnType().getAsString();
     info.ret_raw_type = decl->getReturnType().getCanonicalType().getAsString();
+    info.ret_full_type = clang::TypeName::getFullyQualifiedName(decl->getReturnType(), *m_context, m_context->getPrintingPolicy(), true);
+    detail::collectTypeRefs(decl->getReturnType(), info.ret_type_refs);
 
     for (auto* param_decl : decl->parameters()) {
         ValueMetaInfo param_info;
@@ -251,6 +495,7 @@ inline ReflectASTConsumer::HandleResult ReflectASTConsumer::handleDecl(clang::Fu
     }
 
     info.is_static = decl->isStatic();
+    info.is_deleted = decl->isDeleted();
 
     return kSuccess;
 }
@@ -291,15 +536,54 @@ inline void ReflectASTConsumer::handleDecl(clang::CXXRecordDecl* decl)
         return;
     }
 
+    // entities are extracted from the first translation unit they are found in.
+    auto id = detail::getDeclId(decl);
+    if (!id.empty() && !m_extracted_ids->insert(id).second) {
+        return;
+    }
+
     RecordMetaInfo info;
     if (this->handleDecl(llvm::cast<clang::NamedDecl>(decl), info) == kFailure) {
         return;
     }
 
+    info.id = std::move(id);
+    info.is_polymorphic = decl->isPolymorphic();
+    info.is_abstract = decl->isAbstract();
+    info.is_final = decl->hasAttr<clang::FinalAttr>();
+    if (!decl->isAbstract() && decl->needsImplicitDefaultConstructor()) {
+        info.is_default_constructible = !decl->defaultedDefaultConstructorIsDeleted();
+    } else if (!decl->isAbstract()) {
+        info.is_default_constructible = std::any_of(decl->ctor_begin(), decl->ctor_end(), [](const clang::CXXConstructorDecl* ctor) {
+            return ctor->isDefaultConstructor() && ctor->getAccess() == clang::AS_public && !ctor->isDeleted();
+        });
+    }
+
+    info.is_nested = decl->getDeclContext()->isRecord();
+    const auto* namespace_decl = llvm::dyn_cast<clang::NamespaceDecl>(decl->getDeclContext()->getEnclosingNamespaceContext());
+    if (namespace_decl && !info.is_nested) {
+        // inline namespaces are kept, so the generated code can reopen the exact namespace.
+        auto policy = m_context->getPrintingPolicy();
+        policy.SuppressInlineNamespace = false;
+        llvm::raw_string_ostream scope_outs(info.scope);
+        namespace_decl->printQualifiedName(scope_outs, policy);
+    }
+
+    if (!decl->isDependentType()) {
+        const auto& layout = m_context->getASTRecordLayout(decl);
+        info.size = layout.getSize().getQuantity();
+        info.align = layout.getAlignment().getQuantity();
+    }
+
     for (const auto& base : decl->bases()) {
         auto* base_decl = base.getType()->getAsCXXRecordDecl();
         if (base_decl) {
             info.bases.push_back(base_decl->getQualifiedNameAsString());
+
+            auto* base_definition = base_decl->getDefinition();
+            info.base_refs.push_back(base_definition && detail::isMarked(base_definition)
+                    ? detail::getDeclId(base_definition)
+                    : std::string());
         }
     }
 
@@ -340,9 +624,13 @@ inline void ReflectASTConsumer::handleDecl(clang::CXXRecordDecl* decl)
         }
     }
 
+    clang::ODRHash odr_hash;
+    odr_hash.AddCXXRecordDecl(decl);
+    info.hash = detail::getStructuralHash(odr_hash.CalculateHash(), info);
+
     (*m_metadata)[this->getDeclFilename(decl)].records.push_back(info);
 
-    XPARSE_LOG_INFO("handled record: {0}.", info.full_name);
+    XPARSE_LOG_DEBUG("handled record: {0}.", info.full_name);
 }
 
 inline ReflectASTConsumer::HandleResult ReflectASTConsumer::handleDecl(clang::FieldDecl* decl, FieldMetaInfo& info)
@@ -361,6 +649,24 @@ inline ReflectASTConsumer::HandleResult ReflectASTConsumer::handleDecl(clang::Fi
     }
 
     info.is_static = false;
+    info.is_bitfield = decl->isBitField();
+
+    auto type = decl->getType();
+    if (!info.is_bitfield && !decl->getParent()->isDependentType() && !type->isDependentType()
+        && !type->isIncompleteType() && !type->isReferenceType()) {
+        const auto& layout = m_context->getASTRecordLayout(decl->getParent());
+        info.offset = m_context->toCharUnitsFromBits(layout.getFieldOffset(decl->getFieldIndex())).getQuantity();
+        info.size = m_context->getTypeSizeInChars(type).getQuantity();
+
+        // floating point and class types may compare equal with different bytes.
+        auto element_type = m_context->getBaseElementType(type);
+        info.is_bitwise_comparable = (element_type->isIntegralOrEnumerationType() || element_type->isPointerType())
+            && m_context->hasUniqueObjectRepresentations(type);
+    }
+    if (!type->isDependentType()) {
+        auto element_type = m_context->getBaseElementType(type);
+        info.is_scalar = element_type->isScalarType() && !element_type->isMemberPointerType();
+    }
     if (decl->hasInClassInitializer()) {
         const clang::Expr* default_arg = decl->getInClassInitializer();
         std::string default_value;
@@ -407,6 +713,19 @@ inline ReflectASTConsumer::HandleResult ReflectASTConsumer::handleDecl(clang::CX
     info.is_virtual = decl->isVirtual();
     info.is_pure_virtual = decl->isPureVirtual();
     info.is_override = decl->size_overridden_methods() > 0;
+    info.is_final = decl->hasAttr<clang::FinalAttr>();
+    if (!decl->isAbstract() && decl->needsImplicitDefaultConstructor()) {
+        info.is_default_constructible = !decl->defaultedDefaultConstructorIsDeleted();
+    } else if (!decl->isAbstract()) {
+        info.is_default_constructible = std::any_of(decl->ctor_begin(), decl->ctor_end(), [](const clang::CXXConstructorDecl* ctor) {
+            return ctor->isDefaultConstructor() && ctor->getAccess() == clang::AS_public && !ctor->isDeleted();
+        });
+    }
+    info.is_const = decl->isConst();
+
+    for (const auto* overridden_decl : decl->overridden_methods()) {
+        info.overrides.push_back(detail::getDeclId(overridden_decl));
+    }
 
     return kSuccess;
 }
@@ -417,14 +736,26 @@ inline void ReflectASTConsumer::handleDecl(clang::FunctionDecl* decl)
         return;
     }
 
+    // entities are extracted from the first translation unit they are found in.
+    auto id = detail::getDeclId(decl);
+    if (!id.empty() && !m_extracted_ids->insert(id).second) {
+        return;
+    }
+
     FunctionMetaInfo info;
+    info.id = std::move(id);
     if (this->handleDecl(decl, info) == kFailure) {
         return;
     }
 
+    // only the declaration matters for the metadata, so the body is left out of the hash.
+    clang::ODRHash odr_hash;
+    odr_hash.AddFunctionDecl(decl, true);
+    info.hash = detail::getStructuralHash(odr_hash.CalculateHash(), info);
+
     (*m_metadata)[this->getDeclFilename(decl)].functions.push_back(info);
 
-    XPARSE_LOG_INFO("handled function: {0}.", info.full_name);
+    XPARSE_LOG_DEBUG("handled function: {0}.", info.full_name);
 }
 
 inline void ReflectASTConsumer::handleDecl(clang::EnumDecl* decl)
@@ -433,11 +764,19 @@ inline void ReflectASTConsumer::handleDecl(clang::EnumDecl* decl)
         return;
     }
 
+    // entities are extracted from the first translation unit they are found in.
+    auto id = detail::getDeclId(decl);
+    if (!id.empty() && !m_extracted_ids->insert(id).second) {
+        return;
+    }
+
     EnumMetaInfo info;
     if (this->handleDecl(llvm::cast<clang::NamedDecl>(decl), info) == kFailure) {
         return;
     }
 
+    info.id = std::move(id);
+
     for (auto* constant_decl : decl->enumerators()) {
         EnumConstantMetaInfo constant_info;
         if (this->handleDecl(constant_decl, constant_info) == kSuccess) {
@@ -445,9 +784,13 @@ inline void ReflectASTConsumer::handleDecl(clang::EnumDecl* decl)
         }
     }
 
+    clang::ODRHash odr_hash;
+    odr_hash.AddEnumDecl(decl);
+    info.hash = detail::getStructuralHash(odr_hash.CalculateHash(), info);
+
     (*m_metadata)[this->getDeclFilename(decl)].enums.push_back(info);
 
-    XPARSE_LOG_INFO("handled enum: {0}.", info.full_name);
+    XPARSE_LOG_DEBUG("handled enum: {0}.", info.full_name);
 }
 
 inline ReflectASTConsumer::HandleResult ReflectASTConsumer::handleDecl(clang::EnumConstantDecl* decl, EnumConstantMetaInfo& info)
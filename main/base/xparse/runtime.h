@@ -0,0 +1,282 @@
+/**
+ * *****************************************************************************
+ * @file        runtime.h
+ * @brief       Runtime support for code generated by xparse, has no dependency on llvm.
+ * @author      hsz (hszsoftware@qq.com)
+ * @date        2026-10-19
+ * @copyright   hszsoft
+ * *****************************************************************************
+ */
+
+#ifndef __XPARSE_RUNTIME_H__
+#define __XPARSE_RUNTIME_H__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace xparse {
+
+namespace detail {
+
+    template <typename T>
+    struct TypeTag {
+        static constexpr char tag = 0;
+    };
+
+} // namespace detail
+
+/**
+ * @brief       Identity of a type within the running program, references and cv-qualifiers are ignored.
+ *
+ */
+using TypeId = const void*;
+
+template <typename T>
+constexpr TypeId typeId() noexcept
+{
+    return &detail::TypeTag<std::remove_cv_t<std::remove_reference_t<T>>>::tag;
+}
+
+/**
+ * @brief       Typed access to a public data member through its byte offset.
+ * @note        Static fields are addressed through `address` and ignore the object, which may be nullptr.
+ */
+struct FieldDescriptor {
+    const char* name;
+    TypeId      type;
+    std::size_t offset;
+    void*       address;
+    bool        is_static;
+    bool        is_const;
+
+    template <typename T>
+    T& get(void* object) const noexcept
+    {
+        assert(type == typeId<T>());
+        void* field = is_static ? address : static_cast<char*>(object) + offset;
+        return *static_cast<T*>(field);
+    }
+
+    template <typename T>
+    const T& get(const void* object) const noexcept
+    {
+        return this->get<T>(const_cast<void*>(object));
+    }
+
+    /**
+     * @brief       Static fields can be read without an object, this overload keeps `get<T>(nullptr)` unambiguous.
+     */
+    template <typename T>
+    T& get(std::nullptr_t) const noexcept
+    {
+        assert(is_static);
+        return this->get<T>(static_cast<void*>(nullptr));
+    }
+
+    /**
+     * @brief       Checked version of get, returns nullptr if the type does not match.
+     */
+    template <typename T>
+    T* tryGet(void* object) const noexcept
+    {
+        return type == typeId<T>() ? &this->get<T>(object) : nullptr;
+    }
+
+    template <typename T>
+    void set(void* object, T&& value) const
+    {
+        assert(!is_const);
+        this->get<std::remove_cv_t<std::remove_reference_t<T>>>(object) = std::forward<T>(value);
+    }
+};
+
+/**
+ * @brief       Type erased call of a public method.
+ * @note        `args` holds one pointer per parameter, arguments taken by value or rvalue reference are
+ *              moved from. The result is constructed into `result` if it is not null, a reference result
+ *              is stored as a pointer.
+ */
+struct MethodDescriptor {
+    using Invoker = void (*)(void* object, void* const* args, void* result);
+
+    const char*     name;
+    Invoker         invoke;
+    TypeId          result_type;
+    const TypeId*   param_types;
+    std::size_t     param_count;
+    bool            is_static;
+    bool            is_const;
+};
+
+struct RecordDescriptor {
+    const char*             name;
+    const char*             full_name;
+    const char*             id;
+    TypeId                  type;
+    std::size_t             size;
+    std::size_t             align;
+    const FieldDescriptor*  fields;
+    std::size_t             field_count;
+    const MethodDescriptor* methods;
+    std::size_t             method_count;
+
+    const FieldDescriptor* findField(std::string_view field_name) const noexcept
+    {
+        for (std::size_t i = 0; i < field_count; ++i) {
+            if (field_name == fields[i].name) {
+                return &fields[i];
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief       Find a method by name, returns the first overload in declaration order.
+     */
+    const MethodDescriptor* findMethod(std::string_view method_name) const noexcept
+    {
+        for (std::size_t i = 0; i < method_count; ++i) {
+            if (method_name == methods[i].name) {
+                return &methods[i];
+            }
+        }
+        return nullptr;
+    }
+};
+
+/**
+ * @brief       Specialized by the generated header for every reflected record,
+ *              exposes a constant initialized `static constexpr RecordDescriptor record`.
+ */
+template <typename T>
+struct Reflect;
+
+template <typename T>
+constexpr const RecordDescriptor& reflect() noexcept
+{
+    return Reflect<T>::record;
+}
+
+/**
+ * @brief       Mix a block of bytes into a hash, reading 8 bytes at a time.
+ */
+inline std::size_t hashBytes(const void* data, std::size_t size, std::size_t seed = 0) noexcept
+{
+    constexpr std::uint64_t kMultiplier = 0x9e3779b97f4a7c15ULL;
+    auto mix = [](std::uint64_t value) {
+        value ^= value >> 31;
+        value *= 0xbf58476d1ce4e5b9ULL;
+        value ^= value >> 29;
+        return value;
+    };
+
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    std::uint64_t hash = static_cast<std::uint64_t>(seed) ^ (size * kMultiplier);
+    for (; size >= 8; bytes += 8, size -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes, 8);
+        hash = (hash ^ mix(word)) * kMultiplier;
+    }
+    if (size > 0) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes, size);
+        hash = (hash ^ mix(word)) * kMultiplier;
+    }
+    return static_cast<std::size_t>(mix(hash));
+}
+
+inline std::size_t hashCombine(std::size_t seed, std::size_t value) noexcept
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+/**
+ * @brief       Hash and equality used by generated code, specialized by the generated header
+ *              for records annotated with `hash` and falling back to std::hash and `==` otherwise.
+ */
+template <typename T>
+struct Hash {
+    std::size_t operator()(const T& value) const { return std::hash<T> {}(value); }
+};
+
+template <typename T>
+struct Equal {
+    bool operator()(const T& lhs, const T& rhs) const { return lhs == rhs; }
+};
+
+template <typename T>
+std::size_t hashValue(const T& value)
+{
+    return Hash<T> {}(value);
+}
+
+template <typename T>
+bool equalValue(const T& lhs, const T& rhs)
+{
+    return Equal<T> {}(lhs, rhs);
+}
+
+template <typename T, std::size_t N>
+struct Hash<T[N]> {
+    std::size_t operator()(const T (&values)[N]) const
+    {
+        std::size_t seed = 0;
+        for (const auto& value : values) {
+            seed = hashCombine(seed, hashValue(value));
+        }
+        return seed;
+    }
+};
+
+template <typename T, std::size_t N>
+struct Equal<T[N]> {
+    bool operator()(const T (&lhs)[N], const T (&rhs)[N]) const
+    {
+        for (std::size_t i = 0; i < N; ++i) {
+            if (!equalValue(lhs[i], rhs[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+namespace detail {
+
+    template <typename T>
+    T&& forwardArg(void* arg) noexcept
+    {
+        return static_cast<T&&>(*static_cast<std::remove_reference_t<T>*>(arg));
+    }
+
+    template <typename R, typename Fn>
+    void invokeInto(void* result, Fn&& fn)
+    {
+        if constexpr (std::is_void_v<R>) {
+            fn();
+        } else if constexpr (std::is_reference_v<R>) {
+            auto* pointer = &fn();
+            if (result != nullptr) {
+                *static_cast<std::remove_reference_t<R>**>(result) = pointer;
+            }
+        } else {
+            if (result != nullptr) {
+                ::new (result) R(fn());
+            } else {
+                fn();
+            }
+        }
+    }
+
+} // namespace detail
+
+} // namespace xparse
+
+#endif // __XPARSE_RUNTIME_H__
@@ -13,23 +13,21 @@
 #ifndef __XPARSE_SERIALIZE_H__
 #define __XPARSE_SERIALIZE_H__
 
-#define XPARSE_SERIALIZE_ATTR(NAME)        \
-    outs.attributeBegin(#NAME);            \
-    Serializer::serialize(outs, ins.NAME); \
-    outs.attributeEnd()
+// The attribute list of an object is written once and visited by both the writer and the reader.
+#define XPARSE_SERIALIZE_ATTR(NAME) \
+    visitor.attribute(#NAME, ins.NAME)
 
 #define XPARSE_SERIALIZE_ATTR_FROM_OBJECT(NAME) \
-    Serializer::serializeAttrs(outs, static_cast<const NAME&>(ins))
-
-#define XPARSE_SERIALIZE_OBJECT(NAME)                                               \
-    template <>                                                                     \
-    void Serializer::serializeAttrs(llvm::json::OStream& outs, const NAME& ins);    \
-    template <>                                                                     \
-    inline void Serializer::serialize(llvm::json::OStream& outs, const NAME& ins) { \
-        outs.object([&] { Serializer::serializeAttrs(outs, ins); });                \
-    }                                                                               \
-    template <>                                                                     \
-    inline void Serializer::serializeAttrs(llvm::json::OStream& outs, const NAME& ins)
+    SerializeObject<NAME>::visit(visitor, detail::asBase<NAME>(ins))
+
+#define XPARSE_SERIALIZE_OBJECT(NAME)                            \
+    template <>                                                  \
+    struct SerializeObject<NAME> {                               \
+        template <typename Visitor, typename T>                  \
+        static void visit(Visitor& visitor, T& ins);             \
+    };                                                           \
+    template <typename Visitor, typename T>                      \
+    inline void SerializeObject<NAME>::visit(Visitor& visitor, T& ins)
 
     namespace xparse
 {
@@ -42,6 +40,32 @@
         std::is_arithmetic<T>,
         std::is_constructible<std::string, T>>;
 
+    template <typename T>
+    struct SerializeObject {
+        static_assert(always_false<T>, "No serialization function available for this type.");
+
+        template <typename Visitor, typename U>
+        static void visit(Visitor& /*visitor*/, U& /*ins*/)
+        {
+        }
+    };
+
+    namespace detail {
+
+        template <typename Base, typename T>
+        const Base& asBase(const T& ins)
+        {
+            return static_cast<const Base&>(ins);
+        }
+
+        template <typename Base, typename T>
+        Base& asBase(T& ins)
+        {
+            return static_cast<Base&>(ins);
+        }
+
+    } // namespace detail
+
     class Serializer {
     public:
         template <typename T>
@@ -50,16 +74,13 @@
             if constexpr (serializable<T>::value) {
                 outs.value(ins);
             } else {
-                static_assert(always_false<T>, "No serialization function available for this type.");
+                outs.object([&] {
+                    Writer writer { outs };
+                    SerializeObject<T>::visit(writer, ins);
+                });
             }
         }
 
-        template <typename T>
-        static void serializeAttrs(llvm::json::OStream& /*outs*/, const T& /*ins*/)
-        {
-            static_assert(always_false<T>, "No serialization function available for this type.");
-        }
-
         template <typename T>
         static void serialize(llvm::json::OStream& outs, const std::vector<T>& ins)
         {
@@ -69,6 +90,98 @@
                 }
             });
         }
+
+        /**
+         * @brief       Read a value written by serialize.
+         * @note        Missing attributes keep their default value, so older metadata stays readable.
+         *
+         * @return      false if the json does not match the expected shape.
+         */
+        template <typename T>
+        static bool deserialize(const llvm::json::Value& ins, T& outs)
+        {
+            if constexpr (std::is_same_v<T, bool>) {
+                if (auto value = ins.getAsBoolean()) {
+                    outs = *value;
+                    return true;
+                }
+                return false;
+            } else if constexpr (std::is_same_v<T, uint64_t>) {
+                if (auto value = ins.getAsUINT64()) {
+                    outs = *value;
+                    return true;
+                }
+                return false;
+            } else if constexpr (std::is_integral_v<T>) {
+                if (auto value = ins.getAsInteger()) {
+                    outs = static_cast<T>(*value);
+                    return true;
+                }
+                return false;
+            } else if constexpr (std::is_floating_point_v<T>) {
+                if (auto value = ins.getAsNumber()) {
+                    outs = static_cast<T>(*value);
+                    return true;
+                }
+                return false;
+            } else if constexpr (std::is_same_v<T, std::string>) {
+                if (auto value = ins.getAsString()) {
+                    outs = value->str();
+                    return true;
+                }
+                return false;
+            } else {
+                const auto* object = ins.getAsObject();
+                if (object == nullptr) {
+                    return false;
+                }
+                Reader reader { *object };
+                SerializeObject<T>::visit(reader, outs);
+                return reader.succeeded;
+            }
+        }
+
+        template <typename T>
+        static bool deserialize(const llvm::json::Value& ins, std::vector<T>& outs)
+        {
+            const auto* array = ins.getAsArray();
+            if (array == nullptr) {
+                return false;
+            }
+            outs.resize(array->size());
+            for (size_t i = 0; i < array->size(); ++i) {
+                if (!Serializer::deserialize((*array)[i], outs[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+        struct Writer {
+            llvm::json::OStream& outs;
+
+            template <typename T>
+            void attribute(llvm::StringRef name, const T& value)
+            {
+                outs.attributeBegin(name);
+                Serializer::serialize(outs, value);
+                outs.attributeEnd();
+            }
+        };
+
+        struct Reader {
+            const llvm::json::Object& ins;
+            bool succeeded = true;
+
+            template <typename T>
+            void attribute(llvm::StringRef name, T& value)
+            {
+                if (const auto* element = ins.get(name)) {
+                    succeeded = Serializer::deserialize(*element, value) && succeeded;
+                }
+            }
+        };
     };
 
 } // namespace xparse
@@ -0,0 +1,246 @@
+/**
+ * *****************************************************************************
+ * @file        soa.h
+ * @brief       Struct-of-arrays storage used by generated SoA containers, has no dependency on llvm.
+ * @author      hsz (hszsoftware@qq.com)
+ * @date        2026-10-19
+ * @copyright   hszsoft
+ * *****************************************************************************
+ */
+
+#ifndef __XPARSE_SOA_H__
+#define __XPARSE_SOA_H__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace xparse {
+
+/**
+ * @brief       Contiguous view over one column of a SoA container.
+ *
+ */
+template <typename T>
+class Column {
+public:
+    Column(T* data, std::size_t size) noexcept
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    T* data() const noexcept { return m_data; }
+    std::size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    T* begin() const noexcept { return m_data; }
+    T* end() const noexcept { return m_data + m_size; }
+
+    T& operator[](std::size_t index) const noexcept
+    {
+        assert(index < m_size);
+        return m_data[index];
+    }
+
+private:
+    T*          m_data;
+    std::size_t m_size;
+};
+
+/**
+ * @brief       One separately allocated array per column, all sharing size and capacity.
+ * @note        Columns are aligned to cache lines so they can be loaded with aligned vector instructions.
+ */
+template <typename... Ts>
+class SoAStorage {
+public:
+    static constexpr std::size_t kColumnAlignment = 64;
+
+    template <std::size_t I>
+    using ColumnType = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    SoAStorage() = default;
+
+    SoAStorage(const SoAStorage& other)
+    {
+        this->reserve(other.m_size);
+        this->copyFrom(other, std::index_sequence_for<Ts...> {});
+    }
+
+    SoAStorage(SoAStorage&& other) noexcept
+        : m_columns(std::exchange(other.m_columns, {}))
+        , m_size(std::exchange(other.m_size, 0))
+        , m_capacity(std::exchange(other.m_capacity, 0))
+    {
+    }
+
+    SoAStorage& operator=(SoAStorage other) noexcept
+    {
+        std::swap(m_columns, other.m_columns);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+        return *this;
+    }
+
+    ~SoAStorage()
+    {
+        this->clear();
+        this->deallocate(m_columns, std::index_sequence_for<Ts...> {});
+    }
+
+    std::size_t size() const noexcept { return m_size; }
+    std::size_t capacity() const noexcept { return m_capacity; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    void reserve(std::size_t capacity)
+    {
+        if (capacity > m_capacity) {
+            this->reallocate(capacity, std::index_sequence_for<Ts...> {});
+        }
+    }
+
+    void clear() noexcept
+    {
+        this->destroy(0, m_size, std::index_sequence_for<Ts...> {});
+        m_size = 0;
+    }
+
+    /**
+     * @brief       Append a row, taking one argument per column.
+     */
+    template <typename... Args>
+    void emplace(Args&&... args)
+    {
+        static_assert(sizeof...(Args) == sizeof...(Ts), "one argument per column is required.");
+        if (m_size == m_capacity) {
+            this->reserve(std::max<std::size_t>(m_capacity * 2, 16));
+        }
+        this->construct(m_size, std::index_sequence_for<Ts...> {}, std::forward<Args>(args)...);
+        ++m_size;
+    }
+
+    void pop() noexcept
+    {
+        assert(m_size > 0);
+        this->destroy(m_size - 1, m_size, std::index_sequence_for<Ts...> {});
+        --m_size;
+    }
+
+    /**
+     * @brief       Remove a row and shift the following rows, keeping their order.
+     */
+    void erase(std::size_t index)
+    {
+        assert(index < m_size);
+        this->shift(index, std::index_sequence_for<Ts...> {});
+        this->pop();
+    }
+
+    /**
+     * @brief       Remove a row in constant time by moving the last row into its place.
+     */
+    void swapErase(std::size_t index)
+    {
+        assert(index < m_size);
+        if (index != m_size - 1) {
+            this->moveRow(m_size - 1, index, std::index_sequence_for<Ts...> {});
+        }
+        this->pop();
+    }
+
+    template <std::size_t I>
+    Column<ColumnType<I>> column() noexcept
+    {
+        return { std::get<I>(m_columns), m_size };
+    }
+
+    template <std::size_t I>
+    Column<const ColumnType<I>> column() const noexcept
+    {
+        return { std::get<I>(m_columns), m_size };
+    }
+
+private:
+    template <typename T>
+    static T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(std::max(alignof(T), kColumnAlignment))));
+    }
+
+    template <typename T>
+    static void deallocate(T* data) noexcept
+    {
+        if (data != nullptr) {
+            ::operator delete(data, std::align_val_t(std::max(alignof(T), kColumnAlignment)));
+        }
+    }
+
+    template <std::size_t... Is>
+    static void deallocate(std::tuple<Ts*...>& columns, std::index_sequence<Is...>) noexcept
+    {
+        (deallocate(std::get<Is>(columns)), ...);
+    }
+
+    template <std::size_t... Is>
+    void reallocate(std::size_t capacity, std::index_sequence<Is...>)
+    {
+        std::tuple<Ts*...> columns { allocate<Ts>(capacity)... };
+        (std::uninitialized_move_n(std::get<Is>(m_columns), m_size, std::get<Is>(columns)), ...);
+        (std::destroy_n(std::get<Is>(m_columns), m_size), ...);
+        deallocate(m_columns, std::index_sequence_for<Ts...> {});
+        m_columns = columns;
+        m_capacity = capacity;
+    }
+
+    template <std::size_t... Is, typename... Args>
+    void construct(std::size_t index, std::index_sequence<Is...>, Args&&... args)
+    {
+        (::new (static_cast<void*>(std::get<Is>(m_columns) + index)) Ts(std::forward<Args>(args)), ...);
+    }
+
+    template <std::size_t... Is>
+    void destroy(std::size_t first, std::size_t last, std::index_sequence<Is...>) noexcept
+    {
+        (std::destroy(std::get<Is>(m_columns) + first, std::get<Is>(m_columns) + last), ...);
+    }
+
+    template <std::size_t... Is>
+    void shift(std::size_t index, std::index_sequence<Is...>)
+    {
+        (std::move(std::get<Is>(m_columns) + index + 1, std::get<Is>(m_columns) + m_size, std::get<Is>(m_columns) + index), ...);
+    }
+
+    template <std::size_t... Is>
+    void moveRow(std::size_t from, std::size_t to, std::index_sequence<Is...>)
+    {
+        ((std::get<Is>(m_columns)[to] = std::move(std::get<Is>(m_columns)[from])), ...);
+    }
+
+    template <std::size_t... Is>
+    void copyFrom(const SoAStorage& other, std::index_sequence<Is...>)
+    {
+        (std::uninitialized_copy_n(std::get<Is>(other.m_columns), other.m_size, std::get<Is>(m_columns)), ...);
+        m_size = other.m_size;
+    }
+
+    std::tuple<Ts*...> m_columns {};
+    std::size_t        m_size = 0;
+    std::size_t        m_capacity = 0;
+};
+
+/**
+ * @brief       Specialized by the generated header for records annotated with `soa`, derives from SoAStorage
+ *              with one column per field and adds named column accessors, a row proxy and AoS conversion.
+ */
+template <typename T>
+class SoA;
+
+} // namespace xparse
+
+#endif // __XPARSE_SOA_H__
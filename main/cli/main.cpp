@@ -1,11 +1,186 @@
+#include <xparse/diff.h>
+#include <xparse/generator.h>
+#include <xparse/loader.h>
 #include <xparse/reflect.h>
 
 #include <clang/Tooling/CommonOptionsParser.h>
 #include <clang/Tooling/Tooling.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Program.h>
 
 using clang::tooling::CommonOptionsParser;
 
 static xparse::ProjectMetaInfo s_project_metadata;
+static xparse::PathCache s_path_cache;
+static std::unordered_set<std::string> s_extracted_ids;
+
+static llvm::cl::OptionCategory s_category_option("XParse");
+
+static llvm::cl::opt<xparse::LogLevel> s_log_level(
+    "log-level",
+    llvm::cl::desc("Minimum level of log messages written to stderr."),
+    llvm::cl::values(
+        clEnumValN(xparse::LogLevel::kDebug, "debug", "every extracted entity"),
+        clEnumValN(xparse::LogLevel::kInfo, "info", "progress and summary"),
+        clEnumValN(xparse::LogLevel::kWarn, "warn", "warnings and errors"),
+        clEnumValN(xparse::LogLevel::kError, "error", "errors only"),
+        clEnumValN(xparse::LogLevel::kOff, "off", "nothing")),
+    llvm::cl::init(xparse::LogLevel::kInfo),
+    llvm::cl::cat(s_category_option));
+
+static llvm::cl::opt<xparse::LogFormat> s_log_format(
+    "log-format",
+    llvm::cl::desc("Format of log messages."),
+    llvm::cl::values(
+        clEnumValN(xparse::LogFormat::kText, "text", "one readable line per message"),
+        clEnumValN(xparse::LogFormat::kJson, "json", "one json object per line")),
+    llvm::cl::init(xparse::LogFormat::kText),
+    llvm::cl::cat(s_category_option));
+
+static llvm::cl::opt<bool> s_stats(
+    "stats",
+    llvm::cl::desc("Report the time spent on every translation unit in the summary."),
+    llvm::cl::init(false),
+    llvm::cl::cat(s_category_option));
+
+static llvm::cl::opt<std::string> s_gen_header(
+    "gen-header",
+    llvm::cl::desc("Write the generated code to the given header, which includes one header per source header from a directory named after it."),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(s_category_option));
+
+static llvm::cl::opt<std::string> s_output(
+    "output",
+    llvm::cl::desc("Write the project metadata to the given file instead of stdout, the file is left untouched if unchanged."),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(s_category_option));
+
+static llvm::cl::opt<xparse::CompressionKind> s_compress(
+    "compress",
+    llvm::cl::desc("Compress the project metadata, the xparse loader decompresses it transparently."),
+    llvm::cl::values(
+        clEnumValN(xparse::CompressionKind::kNone, "none", "plain json"),
+        clEnumValN(xparse::CompressionKind::kZlib, "zlib", "framed zlib"),
+        clEnumValN(xparse::CompressionKind::kZstd, "zstd", "framed zstd")),
+    llvm::cl::init(xparse::CompressionKind::kNone),
+    llvm::cl::cat(s_category_option));
+
+static llvm::cl::opt<std::string> s_previous(
+    "previous",
+    llvm::cl::desc("Metadata of the previous run, entities are compared against it by hash."),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(s_category_option));
+
+static llvm::cl::opt<std::string> s_diff_output(
+    "diff-output",
+    llvm::cl::desc("Write added, removed and changed entities compared to --previous as json."),
+    llvm::cl::value_desc("filename"),
+    llvm::cl::cat(s_category_option));
+
+/**
+ * @brief       Leave the file untouched if its content is the same, so dependents are not rebuilt.
+ */
+static bool writeFileIfChanged(llvm::StringRef filename, llvm::StringRef content)
+{
+    auto buffer = llvm::MemoryBuffer::getFile(filename);
+    if (buffer && (*buffer)->getBuffer() == content) {
+        return true;
+    }
+
+    std::error_code error_code;
+    llvm::raw_fd_ostream outs(filename, error_code);
+    if (error_code) {
+        XPARSE_LOG_ERROR("failed to open \"{0}\": {1}", filename, error_code.message());
+        return false;
+    }
+    outs << content;
+    return true;
+}
+
+/**
+ * @brief       Write the header generated for every source header, then the umbrella header including them.
+ * @note        Generated headers whose stamp is unchanged are skipped, and those of removed source headers deleted.
+ */
+static bool writeGeneratedHeaders(llvm::StringRef filename)
+{
+    xparse::Generator generator(s_project_metadata);
+    auto directory_name = llvm::sys::path::stem(filename);
+    llvm::SmallString<256> directory = llvm::sys::path::parent_path(filename);
+    llvm::sys::path::append(directory, directory_name);
+    if (auto error_code = llvm::sys::fs::create_directories(directory)) {
+        XPARSE_LOG_ERROR("failed to create \"{0}\": {1}", directory.str(), error_code.message());
+        return false;
+    }
+
+    size_t generated_count = 0;
+    std::unordered_set<std::string> output_names;
+    for (const auto& source_file : generator.getSourceFiles()) {
+        const auto& output_name = generator.getOutputName(source_file);
+        output_names.insert(output_name);
+
+        llvm::SmallString<256> output = directory;
+        llvm::sys::path::append(output, output_name);
+        auto buffer = llvm::MemoryBuffer::getFile(output);
+        if (buffer && (*buffer)->getBuffer().take_until([](char c) { return c == '\n'; }) == generator.getStamp(source_file)) {
+            continue;
+        }
+
+        std::string content;
+        llvm::raw_string_ostream outs(content);
+        generator.generateFile(source_file, outs);
+        if (!writeFileIfChanged(output, outs.str())) {
+            return false;
+        }
+        ++generated_count;
+    }
+
+    std::error_code error_code;
+    for (llvm::sys::fs::directory_iterator iter(directory, error_code), end; iter != end && !error_code; iter.increment(error_code)) {
+        auto output_name = llvm::sys::path::filename(iter->path());
+        if (output_name.ends_with(".hpp") && output_names.count(output_name.str()) == 0) {
+            llvm::sys::fs::remove(iter->path());
+        }
+    }
+
+    std::string content;
+    llvm::raw_string_ostream outs(content);
+    generator.generate(outs, directory_name);
+    if (!writeFileIfChanged(filename, outs.str())) {
+        return false;
+    }
+
+    XPARSE_LOG_DEBUG("generated {0} of {1} headers.", generated_count, generator.getSourceFiles().size());
+    return true;
+}
+
+static void writeProjectMetaInfo(llvm::raw_ostream& outs)
+{
+    llvm::json::OStream json_outs { outs };
+    json_outs.arrayBegin();
+    for (auto& [filename, file_metadata] : s_project_metadata)
+    {
+        if (xparse::isEmpty(file_metadata)) {
+            continue;
+        }
+        file_metadata.file = filename;
+        xparse::Serializer::serialize(json_outs, file_metadata);
+    }
+    json_outs.arrayEnd();
+}
+
+static void writeProjectMetaInfo(llvm::raw_ostream& outs, xparse::CompressionKind kind)
+{
+    if (kind == xparse::CompressionKind::kNone) {
+        writeProjectMetaInfo(outs);
+        return;
+    }
+    xparse::CompressedOStream compressed_outs { outs, kind };
+    writeProjectMetaInfo(compressed_outs);
+}
+
+using Milliseconds = std::chrono::duration<double, std::milli>;
+
+static std::vector<std::pair<std::string, Milliseconds>> s_unit_times;
 
 class ReflectFrontendAction : public clang::ASTFrontendAction {
 public:
@@ -16,12 +191,80 @@ public:
     {
         auto& options = compiler.getLangOpts();
         options.CommentOpts.ParseAllComments = true;
-        return std::make_unique<xparse::ReflectASTConsumer>(s_project_metadata);
+        return std::make_unique<xparse::ReflectASTConsumer>(s_project_metadata, s_path_cache, s_extracted_ids);
+    }
+
+protected:
+    bool BeginSourceFileAction(clang::CompilerInstance& /*compiler*/) override
+    {
+        m_start = std::chrono::steady_clock::now();
+        return true;
     }
+
+    void EndSourceFileAction() override
+    {
+        Milliseconds elapsed = std::chrono::steady_clock::now() - m_start;
+        s_unit_times.emplace_back(this->getCurrentFile().str(), elapsed);
+
+        XPARSE_LOG_DEBUG("parsed {0} in {1:F1} ms.", this->getCurrentFile(), elapsed.count());
+        xparse::Logger::instance().flush();
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
 };
 
+static void logSummary(Milliseconds elapsed)
+{
+    auto& logger = xparse::Logger::instance();
+    if (!logger.isEnabled(xparse::LogLevel::kInfo)) {
+        return;
+    }
+
+    size_t record_count = 0;
+    size_t function_count = 0;
+    size_t enum_count = 0;
+    for (const auto& [filename, file_metadata] : s_project_metadata) {
+        record_count += file_metadata.records.size();
+        function_count += file_metadata.functions.size();
+        enum_count += file_metadata.enums.size();
+    }
+
+    if (s_stats) {
+        std::sort(s_unit_times.begin(), s_unit_times.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second > rhs.second;
+        });
+        for (const auto& [filename, unit_elapsed] : s_unit_times) {
+            logger.log(xparse::LogLevel::kInfo, llvm::formatv("{0,10:F1} ms  {1}", unit_elapsed.count(), filename),
+                llvm::json::Object { { "file", filename }, { "elapsed_ms", unit_elapsed.count() } });
+        }
+
+        auto hit_count = s_path_cache.getHitCount();
+        auto lookup_count = hit_count + s_path_cache.getMissCount();
+        auto hit_rate = lookup_count == 0 ? 0.0 : 100.0 * hit_count / lookup_count;
+        logger.log(xparse::LogLevel::kInfo,
+            llvm::formatv("path cache: {0} hits, {1} misses, {2:F1}% hit rate.", hit_count, s_path_cache.getMissCount(), hit_rate),
+            llvm::json::Object {
+                { "path_cache_hits", hit_count },
+                { "path_cache_misses", s_path_cache.getMissCount() },
+                { "path_cache_hit_rate", hit_rate } });
+    }
+
+    logger.log(xparse::LogLevel::kInfo,
+        llvm::formatv("extracted {0} records, {1} functions and {2} enums from {3} translation units in {4:F1} ms.",
+            record_count, function_count, enum_count, s_unit_times.size(), elapsed.count()),
+        llvm::json::Object {
+            { "records", record_count },
+            { "functions", function_count },
+            { "enums", enum_count },
+            { "translation_units", s_unit_times.size() },
+            { "elapsed_ms", elapsed.count() } });
+}
+
 int main(int argc, char** argv)
 {
+    auto start = std::chrono::steady_clock::now();
+
     std::vector<const char*> args(argc);
     for (int i = 0; i < argc; ++i) {
         args[i] = argv[i];
@@ -30,6 +273,20 @@ int main(int argc, char** argv)
     args.insert(args.begin() + 1, "--extra-arg=-D__META__");
     argc = llvm::cast<int>(args.size());
 
+    auto expected_options_parser = CommonOptionsParser::create(argc, args.data(), s_category_option);
+    if (!expected_options_parser) {
+        llvm::errs() << expected_options_parser.takeError();
+        return -1;
+    }
+
+    xparse::Logger::instance().setLevel(s_log_level);
+    xparse::Logger::instance().setFormat(s_log_format);
+
+    if (const auto* reason = xparse::getUnsupportedReason(s_compress)) {
+        XPARSE_LOG_ERROR("cannot compress project metadata: {0}", reason);
+        return -1;
+    }
+
     {
         std::string args_content;
         for (size_t i = 0; i < args.size(); ++i) {
@@ -38,14 +295,7 @@ int main(int argc, char** argv)
                 args_content += " ";
             }
         }
-        XPARSE_LOG_INFO("start parsing, command: \"{0}\"", args_content);
-    }
-
-    llvm::cl::OptionCategory s_category_option("XParse");
-    auto expected_options_parser = CommonOptionsParser::create(argc, args.data(), s_category_option);
-    if (!expected_options_parser) {
-        llvm::errs() << expected_options_parser.takeError();
-        return -1;
+        XPARSE_LOG_DEBUG("start parsing, command: \"{0}\"", args_content);
     }
 
     // parse and collect metadata
@@ -57,22 +307,54 @@ int main(int argc, char** argv)
 
     int result = tool.run(clang::tooling::newFrontendActionFactory<ReflectFrontendAction>().get());
 
-    XPARSE_LOG_INFO("parsing completed.");
+    XPARSE_LOG_DEBUG("parsing completed.");
 
-    llvm::json::OStream json_outs { llvm::outs() };
-    json_outs.arrayBegin();
-    for (auto& [filename, file_metadata] : s_project_metadata)
-    {
-        if (xparse::isEmpty(file_metadata)) {
-            continue;
+    if (!s_previous.empty()) {
+        auto previous_metadata = xparse::loadProjectMetaInfo(s_previous.getValue());
+        if (!previous_metadata) {
+            // a missing or stale previous run only means everything is reported as added.
+            XPARSE_LOG_WARN("{0}", llvm::toString(previous_metadata.takeError()));
+            previous_metadata = xparse::ProjectMetaInfo();
+        }
+
+        auto diff = xparse::diffMetadata(*previous_metadata, s_project_metadata);
+        XPARSE_LOG_INFO("compared with previous run: {0} added, {1} removed, {2} changed.",
+            diff.added.size(), diff.removed.size(), diff.changed.size());
+
+        if (!s_diff_output.empty()) {
+            std::string diff_content;
+            llvm::raw_string_ostream diff_outs(diff_content);
+            llvm::json::OStream diff_json_outs { diff_outs, 2 };
+            xparse::Serializer::serialize(diff_json_outs, diff);
+            if (!writeFileIfChanged(s_diff_output.getValue(), diff_outs.str())) {
+                return -1;
+            }
         }
-        file_metadata.file = filename;
-        xparse::Serializer::serialize(json_outs, file_metadata);
     }
-    json_outs.arrayEnd();
-    llvm::outs().flush();
 
-    XPARSE_LOG_INFO("project metadata output completed!");
+    // the previous run is read first, since it may be the file the output replaces.
+    if (s_output.empty()) {
+        if (s_compress != xparse::CompressionKind::kNone) {
+            llvm::sys::ChangeStdoutToBinary();
+        }
+        writeProjectMetaInfo(llvm::outs(), s_compress);
+        llvm::outs().flush();
+    } else {
+        std::string metadata_content;
+        llvm::raw_string_ostream metadata_outs(metadata_content);
+        writeProjectMetaInfo(metadata_outs, s_compress);
+        if (!writeFileIfChanged(s_output.getValue(), metadata_outs.str())) {
+            return -1;
+        }
+    }
+
+    XPARSE_LOG_DEBUG("project metadata output completed!");
+
+    if (!s_gen_header.empty() && !writeGeneratedHeaders(s_gen_header.getValue())) {
+        return -1;
+    }
+
+    logSummary(std::chrono::steady_clock::now() - start);
 
     return result;
 }
@@ -5,5 +5,13 @@ target("cli")
     add_files("**.cpp")
 
     after_build(function (target)
-        os.cp(target:targetfile(), path.join(os.projectdir(), "tools"))
+        local tooldir = path.join(os.projectdir(), "tools")
+        os.cp(target:targetfile(), tooldir)
+
+        -- generated code includes these, the c++.meta rule looks for them next to the tool
+        local includedir = path.join(tooldir, "include", "xparse")
+        os.mkdir(includedir)
+        for _, headerfile in ipairs({ "runtime.h", "soa.h" }) do
+            os.cp(path.join(os.scriptdir(), "..", "base", "xparse", headerfile), includedir)
+        end
     end)
@@ -1,31 +1,227 @@
+#include <clang/AST/ASTConsumer.h>
+#include <clang/AST/ASTNodeTraverser.h>
+#include <clang/AST/Attr.h>
+#include <clang/AST/JSONNodeDumper.h>
+#include <clang/Frontend/CompilerInstance.h>
+#include <clang/Frontend/FrontendAction.h>
 #include <clang/Tooling/CommonOptionsParser.h>
 #include <clang/Tooling/Tooling.h>
+#include <llvm/Support/Regex.h>
 
 using clang::tooling::CommonOptionsParser;
 
+static llvm::cl::OptionCategory s_category_option("Dump-AST");
+
+static llvm::cl::list<std::string> s_name_filters(
+    "decl-name",
+    llvm::cl::desc("Only dump decls whose qualified name matches the regex, can be repeated."),
+    llvm::cl::cat(s_category_option));
+
+static llvm::cl::list<std::string> s_file_filters(
+    "file",
+    llvm::cl::desc("Only dump decls located in a file matching the regex, can be repeated."),
+    llvm::cl::cat(s_category_option));
+
+static llvm::cl::list<std::string> s_annotation_filters(
+    "annotation",
+    llvm::cl::desc("Only dump decls carrying the given clang::annotate string, can be repeated."),
+    llvm::cl::cat(s_category_option));
+
+static llvm::cl::opt<unsigned> s_max_depth(
+    "max-depth",
+    llvm::cl::desc("Maximum depth dumped below each matching decl, 0 for unlimited."),
+    llvm::cl::init(0),
+    llvm::cl::cat(s_category_option));
+
+static llvm::cl::opt<bool> s_system_headers(
+    "system-headers",
+    llvm::cl::desc("Also look into decls from system headers."),
+    llvm::cl::init(false),
+    llvm::cl::cat(s_category_option));
+
+// compiled once from the filters above after they are validated.
+static std::vector<llvm::Regex> s_name_regexes;
+static std::vector<llvm::Regex> s_file_regexes;
+
+/**
+ * @brief       JSONNodeDumper that drops children deeper than the limit.
+ * @note        ASTNodeTraverser calls AddChild through the delegate type, so hiding it here is enough.
+ *              NodeStreamer may defer a child until its next sibling arrives, hence the depth is
+ *              captured when the child is added rather than when it is emitted.
+ */
+class DepthLimitedNodeDumper : public clang::JSONNodeDumper {
+public:
+    DepthLimitedNodeDumper(llvm::raw_ostream& outs, clang::ASTContext& ctx, unsigned max_depth)
+        : clang::JSONNodeDumper(outs, ctx.getSourceManager(), ctx, ctx.getPrintingPolicy(), &ctx.getCommentCommandTraits())
+        , m_max_depth(max_depth)
+    {
+    }
+
+    template <typename Fn>
+    void AddChild(Fn do_add_child)
+    {
+        this->AddChild("", std::move(do_add_child));
+    }
+
+    template <typename Fn>
+    void AddChild(llvm::StringRef label, Fn do_add_child)
+    {
+        int depth = m_depth + 1;
+        if (m_max_depth != 0 && depth > static_cast<int>(m_max_depth)) {
+            return;
+        }
+
+        clang::JSONNodeDumper::AddChild(label, [this, depth, do_add_child] {
+            int parent_depth = m_depth;
+            m_depth = depth;
+            do_add_child();
+            m_depth = parent_depth;
+        });
+    }
+
+private:
+    unsigned m_max_depth;
+    int m_depth = -1;
+};
+
+class FilteredJSONDumper : public clang::ASTNodeTraverser<FilteredJSONDumper, DepthLimitedNodeDumper> {
+public:
+    FilteredJSONDumper(llvm::raw_ostream& outs, clang::ASTContext& ctx, unsigned max_depth)
+        : m_node_dumper(outs, ctx, max_depth)
+    {
+    }
+
+    DepthLimitedNodeDumper& doGetNodeDelegate() { return m_node_dumper; }
+
+private:
+    DepthLimitedNodeDumper m_node_dumper;
+};
+
 class DumpASTConsumer : public clang::ASTConsumer {
 public:
-    DumpASTConsumer() = default;
+    DumpASTConsumer(bool& first_output)
+        : m_first_output(&first_output)
+    {
+    }
 
     void HandleTranslationUnit(clang::ASTContext& ctx) override
     {
+        m_context = &ctx;
         auto* tu_decl = ctx.getTranslationUnitDecl();
-        tu_decl->dump();
+        for (auto* decl : tu_decl->decls()) {
+            this->traverse(decl);
+        }
+        llvm::outs().flush();
+    }
+
+private:
+    void traverse(clang::Decl* decl)
+    {
+        if (decl->isImplicit()) {
+            return;
+        }
+
+        auto location = decl->getLocation();
+        if (!s_system_headers && location.isValid() && m_context->getSourceManager().isInSystemHeader(location)) {
+            return;
+        }
+
+        if (this->isMatched(decl)) {
+            this->dump(decl);
+            return;
+        }
+
+        // function bodies are only dumped as part of a matching function.
+        auto* decl_context = llvm::dyn_cast<clang::DeclContext>(decl);
+        if (decl_context == nullptr || llvm::isa<clang::FunctionDecl>(decl)) {
+            return;
+        }
+        for (auto* child_decl : decl_context->decls()) {
+            this->traverse(child_decl);
+        }
+    }
+
+    bool isMatched(clang::Decl* decl)
+    {
+        if (!s_name_regexes.empty()) {
+            auto* named_decl = llvm::dyn_cast<clang::NamedDecl>(decl);
+            if (named_decl == nullptr || !matchAny(s_name_regexes, named_decl->getQualifiedNameAsString())) {
+                return false;
+            }
+        }
+
+        if (!s_file_regexes.empty()) {
+            auto location = m_context->getSourceManager().getPresumedLoc(decl->getLocation());
+            if (location.isInvalid() || !matchAny(s_file_regexes, location.getFilename())) {
+                return false;
+            }
+        }
+
+        if (!s_annotation_filters.empty()) {
+            bool annotated = false;
+            for (auto* annotate : decl->specific_attrs<clang::AnnotateAttr>()) {
+                annotated = annotated || llvm::is_contained(s_annotation_filters, annotate->getAnnotation().str());
+            }
+            if (!annotated) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void dump(clang::Decl* decl)
+    {
+        auto& outs = llvm::outs();
+        outs << (*m_first_output ? "\n" : ",\n");
+        *m_first_output = false;
+
+        // a json::OStream only accepts a single top-level value, so each match gets its own dumper.
+        FilteredJSONDumper dumper(outs, *m_context, s_max_depth);
+        dumper.Visit(decl);
     }
+
+    static bool matchAny(const std::vector<llvm::Regex>& regexes, llvm::StringRef text)
+    {
+        for (const auto& regex : regexes) {
+            if (regex.match(text)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    clang::ASTContext*  m_context = nullptr;
+    bool*               m_first_output;
 };
 
 class DumpFrontndAction : public clang::ASTFrontendAction {
 public:
-    DumpFrontndAction() = default;
+    DumpFrontndAction(bool& first_output)
+        : m_first_output(&first_output)
+    {
+    }
 
     std::unique_ptr<clang::ASTConsumer>
     CreateASTConsumer(clang::CompilerInstance&  /*compiler*/, llvm::StringRef  /*file*/) override
     {
-        return std::make_unique<DumpASTConsumer>();
+        return std::make_unique<DumpASTConsumer>(*m_first_output);
     }
+
+private:
+    bool* m_first_output;
 };
 
-static llvm::cl::OptionCategory s_category_option("Dump-AST");
+class DumpFrontendActionFactory : public clang::tooling::FrontendActionFactory {
+public:
+    std::unique_ptr<clang::FrontendAction> create() override
+    {
+        return std::make_unique<DumpFrontndAction>(m_first_output);
+    }
+
+private:
+    bool m_first_output = true;
+};
 
 int main(int argc, char** argv)
 {
@@ -39,10 +235,29 @@ int main(int argc, char** argv)
         return -1;
     }
 
+    for (auto [filters, regexes] : { std::make_pair(&s_name_filters, &s_name_regexes), std::make_pair(&s_file_filters, &s_file_regexes) }) {
+        for (const auto& pattern : *filters) {
+            llvm::Regex regex(pattern);
+            std::string error;
+            if (!regex.isValid(error)) {
+                llvm::errs() << "invalid regex \"" << pattern << "\": " << error << "\n";
+                return -1;
+            }
+            regexes->push_back(std::move(regex));
+        }
+    }
+
     auto& options_parser = expected_options_parser.get();
     clang::tooling::ClangTool tool(
         options_parser.getCompilations(),
         options_parser.getSourcePathList());
 
-    return tool.run(clang::tooling::newFrontendActionFactory<DumpFrontndAction>().get());
+    // matches of all translation units are streamed into a single json array.
+    DumpFrontendActionFactory factory;
+    llvm::outs() << "[";
+    int result = tool.run(&factory);
+    llvm::outs() << "\n]\n";
+    llvm::outs().flush();
+
+    return result;
 }
@@ -1,5 +1,4 @@
 target("dump-ast")
-    set_enabled(false)
     set_kind("binary")
     add_packages("libtooling")
     add_files("**.cpp")
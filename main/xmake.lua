@@ -1,3 +1,4 @@
 includes("base/xmake.lua")
+includes("advisor/xmake.lua")
 includes("cli/xmake.lua")
 includes("dump-ast/xmake.lua")
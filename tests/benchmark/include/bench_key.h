@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Bench
+{
+
+enum class Kind : std::uint32_t {
+    kMesh,
+    kTexture,
+    kShader
+};
+
+struct
+[[clang::annotate("__reflect__"), clang::annotate("hash")]]
+CacheKey {
+    std::uint64_t id = 0;
+    Kind kind = Kind::kMesh;
+    std::uint32_t flags = 0;
+    std::int64_t timestamp = 0;
+    std::int32_t shard = 0;
+    std::int32_t version = 0;
+    float quality = 1.0f;
+    std::string name;
+    [[clang::annotate("hash=false")]] std::uint64_t hit_count = 0;
+};
+
+} // namespace Bench
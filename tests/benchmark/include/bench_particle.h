@@ -0,0 +1,22 @@
+#pragma once
+
+namespace Bench
+{
+
+struct
+[[clang::annotate("__reflect__"), clang::annotate("soa")]]
+Particle {
+    float x = 0.0;
+    float y = 0.0;
+    float z = 0.0;
+    float vx = 0.0;
+    float vy = 0.0;
+    float vz = 0.0;
+    float mass = 1.0;
+    int id = 0;
+    double lifetime = 0.0;
+    double spawn_time = 0.0;
+    float radius = 1.0;
+};
+
+} // namespace Bench
@@ -0,0 +1,149 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark-hash/generated/bench_key.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr size_t kCount = 1 << 18;
+static constexpr int kRepeats = 20;
+
+template <typename Fn>
+static double measure(Fn&& fn)
+{
+    double best = 0.0;
+    for (int i = 0; i < kRepeats; ++i) {
+        auto start = Clock::now();
+        fn();
+        double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        best = (i == 0 || elapsed < best) ? elapsed : best;
+    }
+    return best;
+}
+
+static void report(const char* name, double walking, double generated)
+{
+    std::cout << name << ": field walking " << walking << " ms, generated " << generated << " ms, speedup " << walking / generated << "x\n";
+}
+
+// what a generic caching layer does without generated code: dispatch on the type of every field
+// and keep the list of excluded fields by hand.
+template <typename Fn>
+static void dispatch(const xparse::FieldDescriptor& field, Fn&& fn)
+{
+    if (field.type == xparse::typeId<std::uint64_t>()) {
+        fn(static_cast<std::uint64_t*>(nullptr));
+    } else if (field.type == xparse::typeId<std::uint32_t>()) {
+        fn(static_cast<std::uint32_t*>(nullptr));
+    } else if (field.type == xparse::typeId<std::int64_t>()) {
+        fn(static_cast<std::int64_t*>(nullptr));
+    } else if (field.type == xparse::typeId<std::int32_t>()) {
+        fn(static_cast<std::int32_t*>(nullptr));
+    } else if (field.type == xparse::typeId<Bench::Kind>()) {
+        fn(static_cast<Bench::Kind*>(nullptr));
+    } else if (field.type == xparse::typeId<float>()) {
+        fn(static_cast<float*>(nullptr));
+    } else if (field.type == xparse::typeId<std::string>()) {
+        fn(static_cast<std::string*>(nullptr));
+    }
+}
+
+static std::size_t walkHash(const Bench::CacheKey& key)
+{
+    const auto& record = xparse::reflect<Bench::CacheKey>();
+    std::size_t seed = 0;
+    for (std::size_t i = 0; i < record.field_count; ++i) {
+        const auto& field = record.fields[i];
+        if (std::string_view(field.name) == "hit_count") {
+            continue;
+        }
+        dispatch(field, [&](auto* tag) {
+            using T = std::remove_pointer_t<decltype(tag)>;
+            seed = xparse::hashCombine(seed, std::hash<T> {}(field.get<T>(&key)));
+        });
+    }
+    return seed;
+}
+
+static bool walkEqual(const Bench::CacheKey& lhs, const Bench::CacheKey& rhs)
+{
+    const auto& record = xparse::reflect<Bench::CacheKey>();
+    bool equal = true;
+    for (std::size_t i = 0; i < record.field_count && equal; ++i) {
+        const auto& field = record.fields[i];
+        if (std::string_view(field.name) == "hit_count") {
+            continue;
+        }
+        dispatch(field, [&](auto* tag) {
+            using T = std::remove_pointer_t<decltype(tag)>;
+            equal = field.get<T>(&lhs) == field.get<T>(&rhs);
+        });
+    }
+    return equal;
+}
+
+int main()
+{
+    std::vector<Bench::CacheKey> keys(kCount);
+    for (size_t i = 0; i < kCount; ++i) {
+        keys[i].id = i;
+        keys[i].kind = static_cast<Bench::Kind>(i % 3);
+        keys[i].flags = static_cast<std::uint32_t>(i * 31);
+        keys[i].timestamp = static_cast<std::int64_t>(i) * 1000;
+        keys[i].shard = static_cast<std::int32_t>(i % 16);
+        keys[i].version = 1;
+        keys[i].name = "asset";
+        keys[i].hit_count = i;
+    }
+    auto copies = keys;
+    for (auto& copy : copies) {
+        copy.hit_count = 0;
+    }
+
+    // both must agree, excluded fields included.
+    for (size_t i = 0; i < kCount; ++i) {
+        if (walkHash(keys[i]) != walkHash(copies[i]) || xparse::hashValue(keys[i]) != xparse::hashValue(copies[i])
+            || !walkEqual(keys[i], copies[i]) || keys[i] != copies[i]) {
+            std::cerr << "hash or equality mismatch at " << i << "\n";
+            return 1;
+        }
+    }
+
+    volatile std::size_t sink = 0;
+    double walking_hash = measure([&] {
+        std::size_t total = 0;
+        for (const auto& key : keys) {
+            total += walkHash(key);
+        }
+        sink = total;
+    });
+    double generated_hash = measure([&] {
+        std::size_t total = 0;
+        for (const auto& key : keys) {
+            total += std::hash<Bench::CacheKey> {}(key);
+        }
+        sink = total;
+    });
+    report("hash", walking_hash, generated_hash);
+
+    double walking_equal = measure([&] {
+        std::size_t total = 0;
+        for (size_t i = 0; i < kCount; ++i) {
+            total += walkEqual(keys[i], copies[i]);
+        }
+        sink = total;
+    });
+    double generated_equal = measure([&] {
+        std::size_t total = 0;
+        for (size_t i = 0; i < kCount; ++i) {
+            total += keys[i] == copies[i];
+        }
+        sink = total;
+    });
+    report("equal", walking_equal, generated_equal);
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <benchmark-soa/generated/bench_particle.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr size_t kCount = 1 << 20;
+static constexpr int kRepeats = 20;
+
+template <typename Fn>
+static double measure(Fn&& fn)
+{
+    double best = 0.0;
+    for (int i = 0; i < kRepeats; ++i) {
+        auto start = Clock::now();
+        fn();
+        double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        best = (i == 0 || elapsed < best) ? elapsed : best;
+    }
+    return best;
+}
+
+static void report(const char* name, double aos, double soa)
+{
+    std::cout << name << ": aos " << aos << " ms, soa " << soa << " ms, speedup " << aos / soa << "x\n";
+}
+
+int main()
+{
+    std::vector<Bench::Particle> aos(kCount);
+    for (size_t i = 0; i < kCount; ++i) {
+        aos[i].x = static_cast<float>(i);
+        aos[i].vx = 1.0f;
+        aos[i].vy = 2.0f;
+        aos[i].vz = 3.0f;
+        aos[i].mass = static_cast<float>(i % 7);
+        aos[i].id = static_cast<int>(i);
+    }
+    auto soa = xparse::SoA<Bench::Particle>::fromAoS(aos.data(), aos.size());
+
+    // a single column, where SoA only touches the bytes it needs.
+    volatile float sink = 0.0f;
+    double aos_sum = measure([&] {
+        float total = 0.0f;
+        for (const auto& particle : aos) {
+            total += particle.mass;
+        }
+        sink = total;
+    });
+    double soa_sum = measure([&] {
+        float total = 0.0f;
+        for (float mass : soa.mass()) {
+            total += mass;
+        }
+        sink = total;
+    });
+    report("sum mass", aos_sum, soa_sum);
+
+    // several columns updated together.
+    constexpr float dt = 0.016f;
+    double aos_integrate = measure([&] {
+        for (auto& particle : aos) {
+            particle.x += particle.vx * dt;
+            particle.y += particle.vy * dt;
+            particle.z += particle.vz * dt;
+        }
+    });
+    double soa_integrate = measure([&] {
+        auto x = soa.x();
+        auto y = soa.y();
+        auto z = soa.z();
+        auto vx = soa.vx();
+        auto vy = soa.vy();
+        auto vz = soa.vz();
+        for (size_t i = 0; i < soa.size(); ++i) {
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            z[i] += vz[i] * dt;
+        }
+    });
+    report("integrate", aos_integrate, soa_integrate);
+
+    // row proxies, only the columns that are read are loaded.
+    double aos_rows = measure([&] {
+        double total = 0.0;
+        for (const auto& particle : aos) {
+            total += particle.x * particle.mass + particle.lifetime;
+        }
+        sink = static_cast<float>(total);
+    });
+    double soa_rows = measure([&] {
+        double total = 0.0;
+        for (size_t i = 0; i < soa.size(); ++i) {
+            auto particle = soa[i];
+            total += particle.x * particle.mass + particle.lifetime;
+        }
+        sink = static_cast<float>(total);
+    });
+    report("row access", aos_rows, soa_rows);
+
+    return 0;
+}
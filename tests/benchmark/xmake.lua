@@ -0,0 +1,21 @@
+target("benchmark-soa")
+    set_default(false)
+    set_kind("binary")
+    add_includedirs("include")
+    add_files("source/soa.cpp")
+
+target_component("benchmark-soa", "autogen")
+    set_kind("headeronly")
+    add_rules("c++.meta")
+    add_files("include/bench_particle.h")
+
+target("benchmark-hash")
+    set_default(false)
+    set_kind("binary")
+    add_includedirs("include")
+    add_files("source/hash.cpp")
+
+target_component("benchmark-hash", "autogen")
+    set_kind("headeronly")
+    add_rules("c++.meta")
+    add_files("include/bench_key.h")
@@ -1 +1,2 @@
 includes("project-module/**/xmake.lua")
+includes("benchmark/xmake.lua")
@@ -1,3 +1,4 @@
+import("core.base.option")
 import("core.tool.compiler")
 import("core.project.project")
 import("lib.detect.find_tool")
@@ -6,10 +7,27 @@ function __get_project_autogendir()
     return path.join(os.projectdir(), get_config("buildir"), ".xcpp")
 end
 
+-- the runtime headers are installed next to the xparse tool, or taken from the xparse sources this module belongs to
+function __get_runtime_includedir()
+    local xparse = find_tool("xparse")
+    if xparse and path.is_absolute(xparse.program) then
+        local includedir = path.join(path.directory(xparse.program), "include")
+        if os.isfile(path.join(includedir, "xparse", "runtime.h")) then
+            return includedir
+        end
+    end
+    return path.absolute(path.join(os.scriptdir(), "..", "..", "..", "main", "base"))
+end
+
 function setup(target)
     local full_autogendir = path.join(__get_project_autogendir(), target:values("ownername"))
     target:set("values", "autogendir", full_autogendir)
     os.mkdir(full_autogendir)
+
+    -- generated code is included as <ownername/generated.hpp>, or per source header as <ownername/generated/<name>.hpp>
+    -- so that sources are not rebuilt when an unrelated header changes, and depends on <xparse/runtime.h>
+    target:add("includedirs", __get_project_autogendir(), { public = true })
+    target:add("includedirs", __get_runtime_includedir(), { public = true })
 end
 
 function process(target)
@@ -27,7 +45,26 @@ function process(target)
     local collection_path = path.join(target:values("autogendir"), "collection.hpp")
     io.writefile(collection_path, collection)
 
-    local args = { collection_path }
+    local args = { collection_path, "--gen-header=" .. path.join(target:values("autogendir"), "generated.hpp") }
+
+    -- only the summary is printed unless asked for more
+    if option.get("verbose") then
+        table.insert(args, "--log-level=debug")
+    end
+    if option.get("diagnosis") then
+        table.insert(args, "--stats")
+    end
+
+    -- report which entities changed since the last run
+    local metadata_path = path.join(target:values("autogendir"), "meta.json")
+    if os.isfile(metadata_path) then
+        table.insert(args, "--previous=" .. metadata_path)
+        table.insert(args, "--diff-output=" .. path.join(target:values("autogendir"), "meta.diff.json"))
+    end
+
+    -- xparse only rewrites the metadata if it changed, compressed or not
+    table.insert(args, "--output=" .. metadata_path)
+    table.insert(args, "--compress=" .. (get_config("meta_compress") or "none"))
 
     local compilations = compiler.compflags(".cpp", { target = target })
     if target:toolchain("msvc") or target:toolchain("clang-cl") then
@@ -35,14 +72,12 @@ function process(target)
     end
     table.join2(args, "--", compilations)
 
-    local out, err = os.iorunv(find_tool("xparse").program, args)
+    local _, err = os.iorunv(find_tool("xparse").program, args)
     if err and #err > 0 then
         print("┏━━━━━━━━━━━━━━━━━━[" .. target:values("ownername") .. " log]━━━━━━━━━━━━━━━━━━━")
         printf(err)
         print("┗━━━━━━━━━━━━━━━━━━[" .. target:values("ownername") .. " log]━━━━━━━━━━━━━━━━━━━")
     end
-
-    io.writefile(path.join(target:values("autogendir"), "meta.json"), out)
 end
 
 function clean(target)
@@ -0,0 +1,6 @@
+option("meta_compress")
+    set_default("none")
+    set_showmenu(true)
+    set_values("none", "zlib", "zstd")
+    set_description("Compress the metadata written by xparse, it is decompressed transparently when loaded.")
+option_end()